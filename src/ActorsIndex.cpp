@@ -0,0 +1,41 @@
+#include "ActorsIndex.h"
+#include "PerFrame.h"
+
+namespace ActorsIndex
+{
+	// Actors that can be a target at all. Per-caster filters are applied by queries
+	static void collect_actors(std::vector<Entry>& ans)
+	{
+		auto add = [&ans](RE::Actor* a) {
+			if (a && !a->IsDisabled() && !a->IsDead() && a->GetFormType() == RE::FormType::ActorCharacter)
+				ans.push_back({ a, a->GetPosition() });
+		};
+
+		add(RE::PlayerCharacter::GetSingleton());
+
+		if (auto lists = RE::ProcessLists::GetSingleton()) {
+			for (auto& handle : lists->highActorHandles) {
+				add(handle.get().get());
+			}
+			for (auto& handle : lists->middleHighActorHandles) {
+				add(handle.get().get());
+			}
+		}
+	}
+
+	static Grid grid;
+	static uint32_t grid_frame = 0;
+
+	const Grid& get()
+	{
+		if (auto frame = PerFrame::get_frame(); grid_frame != frame) {
+			grid_frame = frame;
+
+			std::vector<Entry> entries;
+			collect_actors(entries);
+			grid.build(std::move(entries));
+		}
+
+		return grid;
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SpatialGrid.h"
+
+namespace ActorsIndex
+{
+	// A candidate for targeting, snapshotted at the moment of the grid building
+	struct Entry
+	{
+		RE::Actor* actor;
+		RE::NiPoint3 pos;
+	};
+
+	// Grid of loaded alive actors
+	using Grid = SpatialGrid<Entry>;
+
+	// Grid of the current frame, rebuilt on the first call in a frame
+	const Grid& get();
+}
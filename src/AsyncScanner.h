@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Nearest actors scans on a worker thread, answered one frame or more after the request.
+// Only plain data crosses threads: handles, positions and filter masks. Filters run on the main thread only.
+// Has no game dependencies: `Actor` is only passed to filters, `Handle` is copied into answers,
+// `Vec` is any type with float x, y, z
+template <typename Actor, typename Handle, typename Vec>
+class AsyncScanner
+{
+public:
+	// Answers hold at most that many nearest actors
+	static constexpr size_t MAX_CANDIDATES = 16;
+
+	// Which actors may be a target. Called on the main thread, once per snapshot actor for every distinct `filter_key`
+	using Filter = std::function<bool(Actor*)>;
+
+	// An actor of the main thread snapshot
+	struct Entry
+	{
+		Actor* actor;
+		Handle handle;
+		Vec pos;
+	};
+
+	AsyncScanner() = default;
+	AsyncScanner(const AsyncScanner&) = delete;
+	AsyncScanner& operator=(const AsyncScanner&) = delete;
+
+	~AsyncScanner() { shutdown(); }
+
+	void start()
+	{
+		shutdown();
+		stop = false;
+		worker_thread = std::thread([this] { worker(); });
+	}
+
+	// Stops and joins the worker, pending requests and answers are dropped
+	void shutdown()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stop = true;
+		}
+		cv.notify_one();
+
+		if (worker_thread.joinable())
+			worker_thread.join();
+
+		std::lock_guard lock(mutex);
+		pending.clear();
+		pending_filters.clear();
+		waiting.clear();
+		ready.clear();
+		job = {};
+		done.clear();
+		has_job = has_done = false;
+	}
+
+	// Asks for actors around `origin` that pass `filter`, the answer is available by the same id since the next frame.
+	// Requests with the same `filter_key` must have the same filter. Does nothing if `id` is already waiting
+	void request(uint32_t id, const Vec& origin, float within_dist2, uint64_t filter_key, Filter filter)
+	{
+		if (!waiting.insert(id).second)
+			return;
+
+		auto mask = static_cast<uint32_t>(pending_filters.size());
+		auto [found, _] = pending_filters.try_emplace(filter_key, mask, std::move(filter));
+		pending.push_back({ id, origin.x, origin.y, origin.z, within_dist2, found->second.first });
+	}
+
+	// Whether a request of `id` is not answered yet
+	bool is_waiting(uint32_t id) const { return waiting.contains(id); }
+
+	// Actors sorted by distance (as they were at the scan), nullopt if the answer is not ready. Every answer is given once
+	std::optional<std::vector<Handle>> take(uint32_t id)
+	{
+		auto found = ready.extract(id);
+		if (found.empty())
+			return std::nullopt;
+		return std::move(found.mapped());
+	}
+
+	// Main thread, once per frame: publishes finished scans and starts pending ones on a snapshot of `entries`.
+	// `get_entry(const T&)` makes an Entry of every element
+	template <typename Entries, typename GetEntry>
+	void on_frame(const Entries& entries, GetEntry&& get_entry)
+	{
+		std::lock_guard lock(mutex);
+
+		// Answers not taken within a frame are dropped, their projectiles ask again
+		if (has_done) {
+			ready = std::move(done);
+			done.clear();
+			has_done = false;
+
+			for (const auto& [id, _] : ready) {
+				waiting.erase(id);
+			}
+		}
+
+		if (!has_job && !pending.empty()) {
+			snapshot(entries, get_entry);
+			job.requests = std::move(pending);
+			pending.clear();
+			pending_filters.clear();
+
+			has_job = true;
+			cv.notify_one();
+		}
+	}
+
+private:
+	struct Candidate
+	{
+		Handle handle;
+		float x, y, z;
+	};
+
+	struct Request
+	{
+		uint32_t id;
+		float x, y, z;  // origin
+		float within_dist2;
+		uint32_t mask;  // index in Job::masks
+	};
+
+	struct Job
+	{
+		std::vector<Candidate> snapshot;
+		std::vector<std::vector<bool>> masks;  // which snapshot actors pass the filter, one per distinct filter
+		std::vector<Request> requests;
+	};
+
+	using Answers = std::unordered_map<uint32_t, std::vector<Handle>>;
+
+	// Worker thread, touches nothing but the job.
+	// Filtered actors are skipped before truncating, so the caster or dead actors never hide farther targets
+	static void scan(const Job& cur, Answers& ans)
+	{
+		std::vector<std::pair<float, uint32_t>> found;
+		for (const auto& request : cur.requests) {
+			const auto& mask = cur.masks[request.mask];
+			found.clear();
+			for (uint32_t i = 0; i < cur.snapshot.size(); i++) {
+				if (!mask[i])
+					continue;
+
+				const auto& c = cur.snapshot[i];
+				float dx = c.x - request.x, dy = c.y - request.y, dz = c.z - request.z;
+				float dist2 = dx * dx + dy * dy + dz * dz;
+				if (dist2 < request.within_dist2)
+					found.push_back({ dist2, i });
+			}
+
+			auto k = std::min(MAX_CANDIDATES, found.size());
+			std::partial_sort(found.begin(), found.begin() + k, found.end());
+
+			auto& handles = ans[request.id];
+			handles.clear();
+			for (size_t i = 0; i < k; i++) {
+				handles.push_back(cur.snapshot[found[i].second].handle);
+			}
+		}
+	}
+
+	void worker()
+	{
+		Job cur;
+		Answers cur_ans;
+		while (true) {
+			{
+				std::unique_lock lock(mutex);
+				cv.wait(lock, [this] { return has_job || stop; });
+				if (stop)
+					return;
+				cur = std::move(job);
+			}
+
+			cur_ans.clear();
+			scan(cur, cur_ans);
+
+			{
+				std::lock_guard lock(mutex);
+				done = std::move(cur_ans);
+				has_job = false;
+				has_done = true;
+			}
+		}
+	}
+
+	// Main thread: positions and filter masks of the actors
+	template <typename Entries, typename GetEntry>
+	void snapshot(const Entries& entries, GetEntry& get_entry)
+	{
+		std::vector<Actor*> actors;
+		job.snapshot.clear();
+		for (const auto& item : entries) {
+			Entry entry = get_entry(item);
+			actors.push_back(entry.actor);
+			job.snapshot.push_back({ entry.handle, entry.pos.x, entry.pos.y, entry.pos.z });
+		}
+
+		job.masks.resize(pending_filters.size());
+		for (auto& [key, filter] : pending_filters) {
+			auto& mask = job.masks[filter.first];
+			mask.resize(actors.size());
+			for (size_t i = 0; i < actors.size(); i++) {
+				mask[i] = filter.second(actors[i]);
+			}
+		}
+	}
+
+	// Owned by the main thread
+	std::vector<Request> pending;
+	std::unordered_map<uint64_t, std::pair<uint32_t, Filter>> pending_filters;  // filter_key -> mask index, filter
+	std::unordered_set<uint32_t> waiting;                                        // ids not answered yet
+	Answers ready;
+
+	// Shared with the worker, guarded by `mutex`
+	std::mutex mutex;
+	std::condition_variable cv;
+	Job job;
+	Answers done;
+	bool has_job = false;   // `job` is given to the worker
+	bool has_done = false;  // worker finished, `done` is not published yet
+	bool stop = false;
+
+	std::thread worker_thread;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+// Resolved nodes of refrs by name. Only the node itself is held, an entry is valid while walking up its parents
+// ends at the current 3D root of the refr, so 3D resets and first/third person switches are caught.
+// Has no game dependencies, `Traits` tells the types and how to get around them:
+//   Node with a `parent` pointer, NodePtr holding a node, Refr with a `formID`, Handle of a refr,
+//   Name and its NameHash, `Handle get_handle(Refr*)`, `Refr* get_refr(const Handle&)` (null if gone),
+//   `Node* find(Node* root, const Name&)`
+template <typename Traits>
+class BonesCache
+{
+	using Node = typename Traits::Node;
+	using NodePtr = typename Traits::NodePtr;
+	using Refr = typename Traits::Refr;
+	using Handle = typename Traits::Handle;
+	using Name = typename Traits::Name;
+
+public:
+	static constexpr float PRUNE_INTERVAL = 2.0f;
+
+	// Node `name` under `root`, the 3D of `refr` for `first_person`. `hit` is whether the cached one is still there
+	Node* get(Refr* refr, bool first_person, Node* root, const Name& name, float now, bool& hit)
+	{
+		prune(now);
+
+		auto& entry = cache[Key{ refr->formID, first_person, name }];
+		entry.last_used = now;
+		hit = entry.node && Traits::get_refr(entry.refr) == refr && get_root(entry.node.get()) == root;
+		if (hit)
+			return entry.node.get();
+
+		entry.refr = Traits::get_handle(refr);
+		entry.node = NodePtr(Traits::find(root, name));
+		return entry.node.get();
+	}
+
+	size_t size() const { return cache.size(); }
+
+	void clear()
+	{
+		cache.clear();
+		last_prune = 0.0f;
+	}
+
+private:
+	struct Key
+	{
+		uint32_t refr;
+		bool first_person;
+		Name name;  // holds the interned string, so its data pointer is never reused
+
+		bool operator==(const Key&) const = default;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const
+		{
+			return typename Traits::NameHash()(key.name) ^ (static_cast<size_t>(key.refr) << 1 | key.first_person);
+		}
+	};
+
+	struct Entry
+	{
+		Handle refr;   // formIDs of refrs may be reused
+		NodePtr node;  // parents detach it when destroyed, so walking up is safe
+		float last_used = 0.0f;
+	};
+
+	static Node* get_root(Node* node)
+	{
+		while (node->parent) {
+			node = node->parent;
+		}
+		return node;
+	}
+
+	// Drops unused entries, a held node keeps its subtree alive after the 3D is unloaded
+	void prune(float now)
+	{
+		if (now - last_prune < PRUNE_INTERVAL)
+			return;
+
+		last_prune = now;
+		std::erase_if(cache, [now](const auto& item) { return now - item.second.last_used > PRUNE_INTERVAL; });
+	}
+
+	std::unordered_map<Key, Entry, KeyHash> cache;
+	float last_prune = 0.0f;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Which followers to kill when a caster has too many. Has no game dependencies
+namespace EvictionPolicy
+{
+	// What to do with a new follower if the caster has too many
+	enum class Eviction : uint32_t
+	{
+		Oldest,    // Kill the oldest follower
+		Farthest,  // Kill the farthest from the caster follower
+		RejectNew  // Don't make the new one a follower
+	};
+
+	// A follower of the caster. Followers are given in order of applying, the oldest first
+	struct Follower
+	{
+		uint32_t type;  // follower ind
+		float dist2;    // from the caster
+	};
+
+	struct Caps
+	{
+		uint32_t type_max;  // per type of the new follower, 0 for unlimited
+		Eviction type_policy;
+		uint32_t global_max;  // all types, 0 for unlimited
+		Eviction global_policy;
+	};
+
+	namespace detail
+	{
+		// Moves `n` of `candidates` chosen by `policy` to `victims`
+		inline void choose(const std::vector<Follower>& followers, std::vector<size_t>& candidates, size_t n, Eviction policy,
+			std::vector<size_t>& victims)
+		{
+			n = std::min(n, candidates.size());
+			if (policy == Eviction::Farthest) {
+				std::stable_sort(candidates.begin(), candidates.end(),
+					[&followers](size_t a, size_t b) { return followers[a].dist2 > followers[b].dist2; });
+			}
+			victims.insert(victims.end(), candidates.begin(), candidates.begin() + n);
+			candidates.erase(candidates.begin(), candidates.begin() + n);
+		}
+	}
+
+	// Fills `victims` with indices of `followers` to kill before a new follower of `type` is added.
+	// The per type cap uses the policy of the type, the cap of all types uses the global policy,
+	// so one type never decides the fate of followers of other types.
+	// False if the new one is rejected, then nothing must be killed
+	inline bool plan(const std::vector<Follower>& followers, uint32_t type, const Caps& caps, std::vector<size_t>& victims)
+	{
+		victims.clear();
+
+		std::vector<size_t> all(followers.size());
+		std::iota(all.begin(), all.end(), size_t(0));
+
+		if (caps.type_max) {
+			std::vector<size_t> same;
+			for (auto i : all) {
+				if (followers[i].type == type)
+					same.push_back(i);
+			}
+
+			if (same.size() >= caps.type_max) {
+				if (caps.type_policy == Eviction::RejectNew)
+					return false;
+
+				detail::choose(followers, same, same.size() - caps.type_max + 1, caps.type_policy, victims);
+				std::erase_if(all,
+					[&victims](size_t i) { return std::find(victims.begin(), victims.end(), i) != victims.end(); });
+			}
+		}
+
+		if (caps.global_max && all.size() >= caps.global_max) {
+			if (caps.global_policy == Eviction::RejectNew) {
+				victims.clear();
+				return false;
+			}
+
+			detail::choose(followers, all, all.size() - caps.global_max + 1, caps.global_policy, victims);
+		}
+
+		return true;
+	}
+}
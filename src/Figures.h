@@ -0,0 +1,214 @@
+#pragma once
+
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Local points of pattern figures. Has no game dependencies
+namespace Figures
+{
+	enum class Shape : uint32_t
+	{
+		Single,
+		Line,
+		Circle,
+		HalfCircle,
+		FillSquare,
+		FillCircle,
+		FillHalfCircle,
+		Sphere,
+		HalfSphere,
+		Cylinder,
+		Custom,     // points from a file, see PointCloud
+		Composite,  // a child figure at every point, made from a pattern with "Child"
+
+		Total
+	};
+
+	// Structure of arrays padded to the SIMD width, padding is zero
+	struct Points
+	{
+		std::vector<float> x, y, z;
+
+		void resize(size_t n)
+		{
+			count = n;
+			n = (n + SIMD::WIDTH - 1) / SIMD::WIDTH * SIMD::WIDTH;
+			x.resize(n);
+			y.resize(n);
+			z.resize(n);
+		}
+
+		size_t size() const { return count; }
+
+	private:
+		size_t count = 0;
+	};
+
+	// Calls `func(i, cos(step * i), sin(step * i))` for `i` in [0, n), rotating a unit vector instead of trig per point
+	template <typename F>
+	void forEachAngle(double step, size_t n, F&& func)
+	{
+		const double c = cos(step);
+		const double s = sin(step);
+		double x = 1.0;
+		double y = 0.0;
+		for (size_t i = 0; i < n; i++) {
+			func(i, static_cast<float>(x), static_cast<float>(y));
+			double t = x * c - y * s;
+			y = y * c + x * s;
+			x = t;
+		}
+	}
+
+	// Points of the figure along (right, up, forward) of the plane, relative to its start.
+	// `out` must be resized to `count`. Custom and Composite have no formula, their points are zero
+	inline void get_local(Shape shape, uint32_t count, float size, Points& out)
+	{
+		float* x = out.x.data();
+		float* y = out.y.data();
+		float* z = out.z.data();
+		std::fill(out.x.begin(), out.x.end(), 0.0f);
+		std::fill(out.y.begin(), out.y.end(), 0.0f);
+		std::fill(out.z.begin(), out.z.end(), 0.0f);
+
+		const size_t n = count;
+		if (n == 1 && shape != Shape::Circle && shape != Shape::FillCircle && shape != Shape::FillHalfCircle)
+			return;
+
+		switch (shape) {
+		case Shape::Line:
+			{
+				float d = size / (n - 1);
+				for (size_t i = 0; i < n; i++) {
+					x[i] = d * i - size * 0.5f;
+				}
+				break;
+			}
+		case Shape::Circle:
+			forEachAngle(2 * 3.1415926 / n, n, [=](size_t i, float c, float s) {
+				x[i] = c * size;
+				y[i] = s * size;
+			});
+			break;
+		case Shape::HalfCircle:
+			forEachAngle(3.1415926 / (n - 1), n, [=](size_t i, float c, float s) {
+				x[i] = c * size;
+				y[i] = s * size;
+			});
+			break;
+		case Shape::FillSquare:
+			{
+				uint32_t m = static_cast<uint32_t>(sqrt(count));
+				uint32_t rest = count - m * m;
+				bool has_right = rest >= m;
+				bool has_up = rest != 0 && rest != m;
+
+				uint32_t w = has_right ? m + 1 : m;
+				uint32_t h = has_up ? m + 1 : m;
+
+				float dx = size / (w - 1);
+				float dy = h == 1 ? 0 : size / (h - 1);
+
+				uint32_t ind = 0;
+				for (; ind < std::min(count, w * m); ind++) {
+					x[ind] = dx * (ind % w) - size * 0.5f;
+					y[ind] = dy * (ind / w) - size * 0.5f;
+				}
+
+				uint32_t up_size = rest >= m ? rest - m : rest;
+				for (uint32_t i = 0; ind < count; ind++, i++) {
+					x[ind] = dx * i - (up_size - 1) * 0.5f * dx;
+					y[ind] = dy * m - size * 0.5f;
+				}
+				break;
+			}
+		case Shape::FillCircle:
+			{
+				float k = size / sqrtf(static_cast<float>(count));
+				forEachAngle(2.3999632297286533222, n, [=](size_t i, float c, float s) {
+					float r = k * sqrtf(static_cast<float>(i));
+					x[i] = c * r;
+					y[i] = s * r;
+				});
+				break;
+			}
+		case Shape::FillHalfCircle:
+			{
+				// Angles are taken modulo pi
+				float k = size / sqrtf(static_cast<float>(count));
+				forEachAngle(0.5 * 2.3999632297286533222, n, [=](size_t i, float c, float s) {
+					float r = s < 0 ? -k * sqrtf(static_cast<float>(i)) : k * sqrtf(static_cast<float>(i));
+					x[i] = c * r;
+					y[i] = s * r;
+				});
+				break;
+			}
+		case Shape::Sphere:
+			forEachAngle(3.883222077450933, n, [=](size_t i, float c, float s) {
+				float h = 1 - (i / (n - 1.0f)) * 2;
+				float radius = sqrt(1 - h * h);
+				x[i] = c * radius * size;
+				y[i] = s * radius * size;
+				z[i] = h * size;
+			});
+			break;
+		case Shape::HalfSphere:
+			forEachAngle(3.883222077450933, n, [=](size_t i, float c, float s) {
+				float h = 1 - (i / (n - 1.0f));
+				float radius = sqrt(1 - h * h);
+				x[i] = c * radius * size;
+				y[i] = h * size;
+				z[i] = s * radius * size;
+			});
+			break;
+		case Shape::Cylinder:
+			forEachAngle(3.883222077450933, n, [=](size_t i, float c, float s) {
+				x[i] = c * size;
+				y[i] = s * size;
+				z[i] = (1 - (i / (n - 1.0f)) * 2) * size;
+			});
+			break;
+		case Shape::Single:
+		case Shape::Custom:
+		case Shape::Composite:
+		case Shape::Total:
+		default:
+			break;
+		}
+	}
+
+	// Rotates points in the plane by `alpha`, same as Geom::rotate around forward.
+	// The basis (right, up, forward) is left-handed, a rotation around forward is the opposite one around z
+	inline void rotate_local(Points& points, float alpha)
+	{
+		if (alpha == 0.0f)
+			return;
+
+		const float c = cos(alpha);
+		const float s = sin(alpha);
+		for (size_t i = 0; i < points.size(); i++) {
+			float x = points.x[i];
+			float y = points.y[i];
+			points.x[i] = x * c + y * s;
+			points.y[i] = y * c - x * s;
+		}
+	}
+
+	// Every point of `child` placed at every point of `parent`, child points of a parent point are contiguous
+	inline void compose(const Points& parent, const Points& child, Points& out)
+	{
+		out.resize(parent.size() * child.size());
+		for (size_t i = 0; i < parent.size(); i++) {
+			for (size_t j = 0; j < child.size(); j++) {
+				auto ind = i * child.size() + j;
+				out.x[ind] = parent.x[i] + child.x[j];
+				out.y[ind] = parent.y[i] + child.y[j];
+				out.z[ind] = parent.z[i] + child.z[j];
+			}
+		}
+	}
+}
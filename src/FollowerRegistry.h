@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Followers of every caster, in the order they were applied. Has no game dependencies:
+// `Proj` is anything with a `formID`, `Handle` is anything whose `get()` is false once the projectile is gone,
+// like RE::Projectile and RE::ProjectileHandle
+template <typename Proj, typename Handle>
+class FollowerRegistry
+{
+public:
+	using FormID = uint32_t;
+
+	enum class Added
+	{
+		New,
+		Again,     // the same projectile is registered already
+		Replaced,  // formID is reused by a new projectile, the old one is gone without being removed
+	};
+
+	Added add(Proj* proj, FormID caster, const Handle& handle)
+	{
+		auto ans = Added::New;
+		auto [found, inserted] = casters.try_emplace(proj->formID, Registered{ proj, caster });
+		if (!inserted) {
+			if (found->second.proj == proj)
+				return Added::Again;
+
+			erase_follower(found->second.caster, proj->formID);
+			found->second = { proj, caster };
+			ans = Added::Replaced;
+		}
+
+		followers[caster].push_back({ proj->formID, handle });
+		return ans;
+	}
+
+	// Only the same projectile, not another one with its formID
+	bool has(const Proj* proj) const
+	{
+		auto found = casters.find(proj->formID);
+		return found != casters.end() && found->second.proj == proj;
+	}
+
+	void remove(const Proj* proj)
+	{
+		auto found = casters.find(proj->formID);
+		if (found == casters.end() || found->second.proj != proj)
+			return;
+
+		erase_follower(found->second.caster, proj->formID);
+		casters.erase(found);
+	}
+
+	// Drops followers that are gone without being removed (e.g. unloaded)
+	std::vector<Handle> get(FormID caster)
+	{
+		std::vector<Handle> ans;
+
+		auto list = followers.find(caster);
+		if (list == followers.end())
+			return ans;
+
+		std::erase_if(list->second, [this](const Follower& item) {
+			if (item.handle.get())
+				return false;
+			casters.erase(item.id);
+			return true;
+		});
+
+		ans.reserve(list->second.size());
+		for (const auto& item : list->second) {
+			ans.push_back(item.handle);
+		}
+
+		if (list->second.empty())
+			followers.erase(list);
+		return ans;
+	}
+
+	size_t size() const { return casters.size(); }
+
+	void clear()
+	{
+		followers.clear();
+		casters.clear();
+	}
+
+	// Registers again the projectiles of `manager` for which `get_caster(Proj*, FormID&)` is true, returns them.
+	// `manager` has `limited`, `pending` and `unlimited` lists of handles, like RE::Projectile::Manager
+	template <typename Manager, typename GetCaster>
+	std::vector<Proj*> rebuild(const Manager& manager, GetCaster&& get_caster)
+	{
+		clear();
+
+		std::vector<Proj*> live;
+		for (auto arr : { &manager.limited, &manager.pending, &manager.unlimited }) {
+			for (const auto& handle : *arr) {
+				FormID caster = 0;
+				if (auto proj = handle.get().get(); proj && get_caster(proj, caster) &&
+				                                    add(proj, caster, handle) != Added::Again)
+					live.push_back(proj);
+			}
+		}
+		return live;
+	}
+
+private:
+	struct Follower
+	{
+		FormID id;
+		Handle handle;
+	};
+
+	struct Registered
+	{
+		const Proj* proj;  // only compared, formIDs of projectiles are reused
+		FormID caster;
+	};
+
+	void erase_follower(FormID caster, FormID id)
+	{
+		if (auto list = followers.find(caster); list != followers.end()) {
+			std::erase_if(list->second, [id](const Follower& item) { return item.id == id; });
+			if (list->second.empty())
+				followers.erase(list);
+		}
+	}
+
+	std::unordered_map<FormID, std::vector<Follower>> followers;  // caster -> followers
+	std::unordered_map<FormID, Registered> casters;              // follower -> caster
+};
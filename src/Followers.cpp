@@ -3,6 +3,15 @@
 #include "RuntimeData.h"
 #include <algorithm>
 #include "Positioning.h"
+#include "PerFrame.h"
+#include "Stats.h"
+#include "Settings.h"
+#include "LOD.h"
+#include "NodeRotation.h"
+#include "OrbitSolver.h"
+#include "EvictionPolicy.h"
+#include "SlotAllocator.h"
+#include "FollowerRegistry.h"
 
 namespace Followers
 {
@@ -13,6 +22,8 @@ namespace Followers
 		None
 	};
 
+	using EvictionPolicy::Eviction;
+
 	// TODO: cylinder
 	enum class Rounding : uint32_t
 	{
@@ -27,6 +38,9 @@ namespace Followers
 
 		Rounding rounding: 2;
 		Collision collision: 2;
+		uint32_t kinematic: 1;  // moved without physics, if instant or rounding
+		Eviction eviction: 2;
+		uint32_t max_count: 16;  // per caster, 0 for unlimited
 		float rounding_radius;  // if rounding
 		float speed_mult;       // 0 for instant, default: 1
 
@@ -35,7 +49,16 @@ namespace Followers
 			rounding_radius(rounding != Rounding::None ? JsonUtils::getFloat(item, "roundingR") : 0),
 			collision(JsonUtils::mb_read_field<Collision::Actor>(item, "collision")),
 			speed_mult(JsonUtils::mb_getFloat<1.0f>(item, "speed"))
-		{}
+		{
+			kinematic = JsonUtils::mb_read_field<false>(item, "kinematic") &&
+			            (speed_mult == 0.0f || rounding != Rounding::None);
+			if (kinematic && collision != Collision::None) {
+				logger::warn("kinematic followers have no collisions, set collision to None to use it");
+				kinematic = false;
+			}
+			eviction = JsonUtils::mb_read_field<Eviction::Oldest>(item, "eviction");
+			max_count = JsonUtils::mb_read_field<0u>(item, "maxCount");
+		}
 	};
 	static_assert(sizeof(Data) == 0x40);
 
@@ -89,30 +112,169 @@ namespace Followers
 
 	uint32_t get_key_ind(const std::string& filename, const std::string& key) { return Storage::get_key_ind(filename, key); }
 
+	// Pattern slots taken per (caster, follower type), lowest free slot first
+	class Slots
+	{
+	public:
+		// Slot for a new follower, 0 (shared) if all are taken
+		static uint32_t claim(RE::Projectile* proj, RE::FormID caster, uint32_t follower_ind, uint32_t size)
+		{
+			uint64_t key = (static_cast<uint64_t>(caster) << 32) | follower_ind;
+			auto slot = allocators[key].claim(size);
+			if (slot == SlotAllocator::NONE)
+				return 0;
+
+			claims.insert_or_assign(proj->formID, Claim{ key, slot });
+			return slot;
+		}
+
+		static void release(RE::Projectile* proj)
+		{
+			auto found = claims.find(proj->formID);
+			if (found == claims.end())
+				return;
+
+			if (auto allocator = allocators.find(found->second.key); allocator != allocators.end()) {
+				allocator->second.release(found->second.slot);
+				if (allocator->second.empty())
+					allocators.erase(allocator);
+			}
+			claims.erase(found);
+		}
+
+		static uint32_t get(RE::Projectile* proj)
+		{
+			auto found = claims.find(proj->formID);
+			return found == claims.end() ? 0 : found->second.slot;
+		}
+
+		// Allocators are made again from the claims of `live` followers, others are forgotten.
+		// Live followers keep their slots, so new ones do not take them
+		static void rebuild(const std::vector<RE::Projectile*>& live)
+		{
+			auto old = std::move(claims);
+			claims.clear();
+			allocators.clear();
+			for (auto proj : live) {
+				if (auto found = old.find(proj->formID); found != old.end()) {
+					allocators[found->second.key].take(found->second.slot);
+					claims.insert(*found);
+				}
+			}
+		}
+
+	private:
+		struct Claim
+		{
+			uint64_t key;
+			uint32_t slot;
+		};
+
+		static inline std::unordered_map<uint64_t, SlotAllocator> allocators;
+		static inline std::unordered_map<RE::FormID, Claim> claims;  // follower -> its slot
+	};
+
+	// Shape index doesn't fit into runtime data, it is kept by Slots
+	constexpr uint32_t SHAPE_IND_OVERFLOW = 255;
+
 	void set_follower_ind(RE::Projectile* proj, uint32_t ind) { ::set_follower_ind(proj, ind); }
 	uint32_t get_follower_ind(RE::Projectile* proj) { return ::get_follower_ind(proj); }
-	void set_follower_shape_ind(RE::Projectile* proj, uint32_t ind) { ::set_follower_shape_ind(proj, ind); }
-	uint32_t get_follower_shape_ind(RE::Projectile* proj) { return ::get_follower_shape_ind(proj); }
+	void set_follower_shape_ind(RE::Projectile* proj, uint32_t ind)
+	{
+		::set_follower_shape_ind(proj, std::min(ind, SHAPE_IND_OVERFLOW));
+	}
+	uint32_t get_follower_shape_ind(RE::Projectile* proj)
+	{
+		auto ind = ::get_follower_shape_ind(proj);
+		return ind == SHAPE_IND_OVERFLOW ? Slots::get(proj) : ind;
+	}
 	bool is_follower(RE::Projectile* proj) { return get_follower_ind(proj) != 0; }
+	bool is_kinematic(RE::Projectile* proj) { return is_follower(proj) && Storage::get_data(get_follower_ind(proj)).kinematic; }
 	void disable_follower(RE::Projectile* proj) { set_follower_ind(proj, 0); }
 
 	namespace Moving
 	{
-		auto get_target_point(RE::Projectile* proj)
+		// Pattern frame of a caster's followers of one type, computed once per frame and shared by them
+		class Formations
 		{
-			auto& data = Storage::get_data(get_follower_ind(proj));
+			static constexpr uint32_t PRUNE_FRAMES = 300;
 
-			RE::NiPoint3 final_vel;
-			auto caster = proj->shooter.get().get()->As<RE::Actor>();
-			RE::Projectile::ProjectileRot dir{ caster->GetAngleX(), caster->GetAngleZ() };
+		public:
+			struct Formation
+			{
+				uint32_t frame;
+				RE::NiPoint3 center;
+				RE::NiPoint3 cast_dir;  // unit
+				Positioning::Plane plane;
+				Positioning::Positions slots;
+			};
+
+			static Formation& get(RE::Projectile* proj)
+			{
+				auto ind = get_follower_ind(proj);
+				auto caster = proj->shooter.get().get()->As<RE::Actor>();
+				auto frame = PerFrame::get_frame();
+				prune(frame);
+
+				uint64_t key = (static_cast<uint64_t>(caster->formID) << 32) | ind;
+				auto found = formations.find(key);
+				if (found != formations.end() && found->second.frame == frame) {
+					Stats::inc(Stats::Counter::FormationHit);
+					return found->second;
+				}
+				Stats::inc(Stats::Counter::FormationMiss);
 
-			RE::NiPoint3 spawn_center = caster->GetPosition();
-			data.pattern.initCenter(spawn_center, dir, caster);
-			RE::NiPoint3 cast_dir = data.pattern.getCastDir(dir);
-			cast_dir.Unitize();
+				auto& data = Storage::get_data(ind);
+				RE::Projectile::ProjectileRot dir{ caster->GetAngleX(), caster->GetAngleZ() };
 
-			return data.pattern.GetPosition(spawn_center, cast_dir, get_follower_shape_ind(proj));
-		}
+				RE::NiPoint3 center = caster->GetPosition();
+				data.pattern.initCenter(center, dir, caster);
+				RE::NiPoint3 cast_dir = data.pattern.getCastDir(dir);
+				cast_dir.Unitize();
+
+				if (found == formations.end()) {
+					found = formations.insert({ key, Formation{ frame, center, cast_dir, { center, cast_dir }, {} } }).first;
+				} else {
+					auto& formation = found->second;
+					formation.frame = frame;
+					formation.center = center;
+					formation.cast_dir = cast_dir;
+					formation.plane = { center, cast_dir };
+				}
+
+				auto& formation = found->second;
+				data.pattern.GetPositions(formation.plane, formation.slots, PerFrame::get_precise_time());
+				return formation;
+			}
+
+			static RE::NiPoint3 get_slot(RE::Projectile* proj)
+			{
+				auto& formation = get(proj);
+				auto& data = Storage::get_data(get_follower_ind(proj));
+				auto ind = get_follower_shape_ind(proj);
+				if (ind >= formation.slots.size())
+					return data.pattern.GetPosition(formation.plane, formation.cast_dir, ind);
+
+				return formation.slots[ind];
+			}
+
+			static void clear() { formations.clear(); }
+
+		private:
+			static void prune(uint32_t frame)
+			{
+				if (frame - last_prune < PRUNE_FRAMES)
+					return;
+
+				last_prune = frame;
+				std::erase_if(formations, [frame](const auto& item) { return frame - item.second.frame >= PRUNE_FRAMES; });
+			}
+
+			static inline std::unordered_map<uint64_t, Formation> formations;
+			static inline uint32_t last_prune = 0;
+		};
+
+		RE::NiPoint3 get_target_point(RE::Projectile* proj) { return Formations::get_slot(proj); }
 
 		RE::NiPoint2 rotate(RE::NiPoint2 P, float alpha)
 		{
@@ -121,9 +283,8 @@ namespace Followers
 			return { P.x * _cos - P.y * _sin, P.y * _cos + P.x * _sin };
 		}
 
-		const float CIRCLE_K = 0.01f;
-		const float CIRCLE_K_BIG = 1.0f + CIRCLE_K;
-		const float CIRCLE_K_SML = 1.0f - CIRCLE_K;
+		using OrbitSolver::CIRCLE_K_BIG;
+		using OrbitSolver::CIRCLE_K_SML;
 
 		RE::NiPoint3 get_target_point_rounding_sphere(RE::Projectile* proj, RE::NiPoint3* dV)
 		{
@@ -182,16 +343,14 @@ namespace Followers
 				// On circle
 				// Move around the circle
 
-				float phi = dtime * speed_origin / R;
+				auto ans = OrbitSolver::step_sphere(proj->GetPosition(), proj->linearVelocity, target_pos, R, dtime);
 				RE::NiPoint3 proj_dir_final = (proj->GetPosition() - target_pos).UnitCross(cast_dir);
 				if (proj_dir_final.Dot(proj->linearVelocity) < 0) {
 					proj_dir_final *= -1;
-				} else {
-					phi *= -1;
 				}
 
 				proj->linearVelocity = proj_dir_final * speed_origin;
-				return FenixUtils::Geom::rotate(proj->GetPosition(), phi, target_pos, cast_dir);
+				return ans;
 			}
 		}
 
@@ -206,12 +365,9 @@ namespace Followers
 			float R = data.rounding_radius;
 			float R2 = R * R;
 
-			auto caster = proj->shooter.get().get()->As<RE::Actor>();
-			RE::NiPoint3 cast_dir = data.pattern.getCastDir({ caster->GetAngleX(), caster->GetAngleZ() });
-			cast_dir.Unitize();
+			auto cast_dir = Formations::get(proj).cast_dir;
 			Positioning::Plane plane(target_pos, cast_dir);
 
-			float dir_z = -cast_dir.Dot(proj->GetPosition() - target_pos);
 			RE::NiPoint2 P = plane.project(proj->GetPosition() - target_pos);
 			RE::NiPoint2 vel = plane.project(proj->linearVelocity);
 
@@ -253,26 +409,88 @@ namespace Followers
 				// On cylinder
 				// Move around the cylinder
 
-				float L = dtime * speed_origin;
-				float H = abs(dir_z);
-				float t;
+				return OrbitSolver::step_plane(proj->GetPosition(), proj->linearVelocity, target_pos, cast_dir, R, dtime);
+			}
+		}
 
-				if (L > H + 0.0001f) {
-					t = std::min(1.0f, H / sqrtf(L * L - H * H));
-				} else {
-					t = 1;
+		// Rounding followers of a frame are gathered on the first rounding update in the frame.
+		// The ones moving along their orbits are rotated all at once, others go through get_target_point_rounding_*
+		namespace Orbits
+		{
+			struct Item
+			{
+				RE::Projectile* proj;  // only compared, never dereferenced
+				RE::NiPoint3 pos;
+				RE::NiPoint3 vel;
+				uint32_t lane;  // in the batch
+			};
+
+			static std::vector<Item> items;  // only followers on their orbits
+			static std::unordered_map<RE::FormID, uint32_t> slots;
+			static OrbitSolver::Batch batch;
+			static uint32_t batch_frame = 0;
+			static float batch_dtime = 0.0f;
+
+			static void gather(const RE::BSTArray<RE::ProjectileHandle>& arr)
+			{
+				for (auto& handle : arr) {
+					auto proj = handle.get().get();
+					if (!proj || !is_follower(proj))
+						continue;
+
+					auto& data = Storage::get_data(get_follower_ind(proj));
+					if (data.speed_mult == 0 || data.rounding == Rounding::None)
+						continue;
+
+					// Followers off their orbits take the scalar path anyway, so lanes are given only to the ones on them
+					bool sphere = data.rounding == Rounding::Sphere;
+					auto pos = proj->GetPosition();
+					auto target_pos = get_target_point(proj);
+					auto cast_dir = sphere ? RE::NiPoint3() : Formations::get(proj).cast_dir;
+					if (!OrbitSolver::on_orbit(pos, target_pos, cast_dir, data.rounding_radius, sphere))
+						continue;
+
+					auto lane = batch.add(pos, proj->linearVelocity, target_pos, cast_dir, data.rounding_radius, sphere);
+					slots.insert_or_assign(proj->formID, static_cast<uint32_t>(items.size()));
+					items.push_back({ proj, pos, proj->linearVelocity, lane });
 				}
+			}
 
-				float dl = L / sqrtf(1 + t * t);
-				float dh = dl * t;
-				float df = dl / R;
-				if (P.Cross(vel) >= 0)
-					df *= -1;
-				auto ans = FenixUtils::Geom::rotate(proj->GetPosition(), df, target_pos, cast_dir);
-				if (dir_z < 0)
-					dh *= -1;
-				ans += cast_dir * dh;
-				return ans;
+			static void build(float dtime)
+			{
+				items.clear();
+				slots.clear();
+				batch.clear();
+
+				auto manager = RE::Projectile::Manager::GetSingleton();
+				gather(manager->limited);
+				gather(manager->unlimited);
+
+				batch.solve(dtime);
+			}
+
+			// Returns false if the follower is not on its orbit or changed since gathering,
+			// it must be processed by the usual path then
+			bool get_target_point(RE::Projectile* proj, RE::NiPoint3* dV, RE::NiPoint3& P)
+			{
+				float dtime = sqrtf(dV->SqrLength() / proj->linearVelocity.SqrLength());
+
+				if (auto frame = PerFrame::get_frame(); batch_frame != frame) {
+					batch_frame = frame;
+					batch_dtime = dtime;
+					build(dtime);
+				}
+
+				bool batched = false;
+				if (auto found = slots.find(proj->formID); found != slots.end()) {
+					auto i = found->second;
+					batched = items[i].proj == proj && items[i].pos == proj->GetPosition() &&
+					          items[i].vel == proj->linearVelocity && abs(dtime - batch_dtime) <= batch_dtime * 0.0001f &&
+					          batch.get(items[i].lane, P);
+				}
+
+				Stats::inc(batched ? Stats::Counter::OrbitsBatched : Stats::Counter::OrbitsScalar);
+				return batched;
 			}
 		}
 
@@ -305,16 +523,14 @@ namespace Followers
 			}
 
 			// Smooth rotating
-			RE::NiPoint3 proj_dir;
 			if (proj->linearVelocity.SqrLength() > 30.0f) {
-				proj_dir = proj->linearVelocity;
+				NodeRotation::update(proj, proj->linearVelocity);
 			} else {
 				auto proj_dir_final = FenixUtils::Geom::angles2dir(proj->shooter.get().get()->data.angle);
 				auto proj_dir_cur = FenixUtils::Geom::angles2dir(proj->data.angle);
-				proj_dir = FenixUtils::Geom::rotateVel(proj_dir_cur, data.speed_mult * dtime, proj_dir_final);
+				auto proj_dir = FenixUtils::Geom::rotateVel(proj_dir_cur, data.speed_mult * dtime, proj_dir_final);
+				NodeRotation::update(proj, proj_dir, proj_dir_final);
 			}
-			FenixUtils::Geom::Projectile::update_node_rotation(proj, proj_dir);
-			
 		}
 
 		void change_direction_instant(RE::Projectile* proj, RE::NiPoint3* dV)
@@ -327,12 +543,11 @@ namespace Followers
 				P = get_target_point(proj);
 				proj_dir = FenixUtils::Geom::angles2dir(proj->shooter.get().get()->data.angle);
 				proj_dir.Unitize();
-			} else if (data.rounding == Rounding::Sphere) {
-				P = get_target_point_rounding_sphere(proj, dV);
-			} else if (data.rounding == Rounding::Plane) {
-				P = get_target_point_rounding_plane(proj, dV);
-			} else {
+			} else if (data.rounding == Rounding::None) {
 				return;
+			} else if (!Orbits::get_target_point(proj, dV, P)) {
+				P = data.rounding == Rounding::Sphere ? get_target_point_rounding_sphere(proj, dV) :
+				                                        get_target_point_rounding_plane(proj, dV);
 			}
 
 			if (data.rounding == Rounding::Sphere || data.rounding == Rounding::Plane) {
@@ -341,9 +556,22 @@ namespace Followers
 				proj->linearVelocity = proj_dir * proj->linearVelocity.Length();
 			}
 
-			FenixUtils::Geom::Projectile::update_node_rotation(proj, proj_dir);
+			NodeRotation::update(proj, proj_dir);
 			*dV = P - proj->GetPosition();
 		}
+
+		// Havok is skipped, the projectile is just put to the point. Its phantom is left behind until reseat
+		void move_kinematic(RE::Projectile* proj, const RE::NiPoint3& dV)
+		{
+			auto P = proj->GetPosition() + dV;
+			proj->data.location = P;
+			proj->distanceMoved += dV.Length();
+			if (auto node = proj->Get3D()) {
+				node->local.translate = P;
+				RE::NiUpdateData ctx;
+				node->Update(ctx);
+			}
+		}
 	}
 
 	namespace Hooks
@@ -364,7 +592,7 @@ namespace Followers
 			static bool change_direction(RE::Projectile* proj, RE::NiPoint3* dV, float dtime)
 			{
 				bool ans = _Projectile__apply_gravity(proj, dV, dtime);
-				if (is_follower(proj)) {
+				if (is_follower(proj) && !is_kinematic(proj) && LOD::update_now(proj, dtime)) {
 					Moving::change_direction(proj, dV, dtime);
 				}
 				return ans;
@@ -374,6 +602,11 @@ namespace Followers
 			{
 				if (is_follower(proj)) {
 					Moving::change_direction_instant(proj, dV);
+
+					if (is_kinematic(proj)) {
+						Moving::move_kinematic(proj, *dV);
+						return;
+					}
 				}
 
 				_Projectile__MovePoint(proj, dV);
@@ -381,6 +614,15 @@ namespace Followers
 
 			static inline REL::Relocation<decltype(change_direction)> _Projectile__apply_gravity;
 			static inline REL::Relocation<decltype(change_direction_instant)> _Projectile__MovePoint;
+
+		public:
+			// Brings the Havok phantom of a kinematic follower to the projectile.
+			// Must be called while it is still non-collidable, so the sweep hits nothing
+			static void reseat(RE::Projectile* proj)
+			{
+				RE::NiPoint3 zero;
+				_Projectile__MovePoint(proj, &zero);
+			}
 		};
 
 		class NoCollisionHook
@@ -499,56 +741,87 @@ namespace Followers
 		};
 	}
 
-	void get_unused_shape_ind(RE::Projectile* proj, std::set<uint32_t>& ans, const RE::BSTArray<RE::ProjectileHandle>& a)
+	// Followers of every caster, in the order they were applied
+	class Registry
 	{
-		auto baseType = get_follower_ind(proj);
-		for (auto& i : a) {
-			if (auto _proj = i.get().get(); _proj && get_follower_ind(_proj) == baseType && _proj->formID != proj->formID) {
-				uint32_t ind = get_follower_shape_ind(_proj);
-				ans.erase(ind);
-			}
+		using Impl = FollowerRegistry<RE::Projectile, RE::ProjectileHandle>;
+
+	public:
+		static void add(RE::Projectile* proj)
+		{
+			auto caster = proj->shooter.get().get();
+			if (!caster)
+				return;
+
+			if (registry.add(proj, caster->formID, proj->GetHandle()) == Impl::Added::Replaced)
+				logger::info("Follower {:X} is registered again for a new projectile, the stale entry is replaced",
+					proj->formID);
 		}
-	}
 
-	uint32_t get_unused_shape_ind(RE::Projectile* proj)
-	{
-		std::set<uint32_t> ans;
+		static bool has(RE::Projectile* proj) { return registry.has(proj); }
+
+		static void remove(RE::Projectile* proj) { registry.remove(proj); }
+
+		// Drops followers that are gone without being killed (e.g. unloaded)
+		static std::vector<RE::ProjectileHandle> get(RE::FormID caster) { return registry.get(caster); }
+
+		static void rebuild()
 		{
-			auto& data = Storage::get_data(get_follower_ind(proj));
-			int tmp = 0;
-			std::generate_n(std::inserter(ans, ans.begin()), data.pattern.getSize(), [&tmp]() { return tmp++; });
+			auto manager = RE::Projectile::Manager::GetSingleton();
+			auto live = registry.rebuild(*manager, [](RE::Projectile* proj, RE::FormID& caster) {
+				auto shooter = proj->shooter.get().get();
+				if (!shooter || !is_follower(proj))
+					return false;
+				caster = shooter->formID;
+				return true;
+			});
+			Slots::rebuild(live);
 		}
 
-		auto manager = RE::Projectile::Manager::GetSingleton();
-		get_unused_shape_ind(proj, ans, manager->limited);
-		get_unused_shape_ind(proj, ans, manager->pending);
-		get_unused_shape_ind(proj, ans, manager->unlimited);
-		return ans.begin() == ans.end() ? -1 : *ans.begin();
-	}
+	private:
+		static inline Impl registry;
+	};
+
+	std::vector<RE::ProjectileHandle> get_followers(RE::TESObjectREFR* a) { return Registry::get(a->formID); }
 
-	forEachRes forEachFollower(RE::TESObjectREFR* a, const RE::BSTArray<RE::ProjectileHandle>& arr,
-		const forEachF& func)
+	namespace Hooks
 	{
-		for (auto& i : arr) {
-			if (auto proj = i.get().get(); proj && proj->shooter.get().get()) {
-				if (proj->shooter.get().get()->formID == a->formID && is_follower(proj)) {
-					if (func(proj) == forEachRes::kStop)
-						return forEachRes::kStop;
+		// Unregister killed followers, free slots of hit ones
+		class ReleaseHook
+		{
+		public:
+			static void Hook()
+			{
+				_AddImpact = SKSE::GetTrampoline().write_call<5>(REL::ID(42547).address() + 0x56,
+					AddImpact);  // SkyrimSE.exe+732456
+				_BSSoundHandle__ClearFollowedObject = SKSE::GetTrampoline().write_call<5>(REL::ID(42930).address() + 0x21,
+					BSSoundHandle__ClearFollowedObject);  // SkyrimSE.exe+74BC21
+			}
+
+		private:
+			static void* AddImpact(RE::Projectile* proj, RE::TESObjectREFR* a2, RE::NiPoint3* a3, RE::NiPoint3* a_velocity,
+				RE::hkpCollidable* a_collidable, uint32_t a6, char a7)
+			{
+				auto ans = _AddImpact(proj, a2, a3, a_velocity, a_collidable, a6, a7);
+				if (is_follower(proj)) {
+					Slots::release(proj);
 				}
+				return ans;
 			}
-		}
-		return forEachRes::kContinue;
-	}
 
-	void forEachFollower(RE::TESObjectREFR* a, const forEachF& func)
-	{
-		auto manager = RE::Projectile::Manager::GetSingleton();
-		if (forEachFollower(a, manager->limited, func) == forEachRes::kStop)
-			return;
-		if (forEachFollower(a, manager->pending, func) == forEachRes::kStop)
-			return;
-		if (forEachFollower(a, manager->unlimited, func) == forEachRes::kStop)
-			return;
+			static void BSSoundHandle__ClearFollowedObject(char* sound)
+			{
+				_BSSoundHandle__ClearFollowedObject(sound);
+				auto proj = reinterpret_cast<RE::Projectile*>(sound - 0x128);
+				if (is_follower(proj)) {
+					Slots::release(proj);
+					Registry::remove(proj);
+				}
+			}
+
+			static inline REL::Relocation<decltype(AddImpact)> _AddImpact;
+			static inline REL::Relocation<decltype(BSSoundHandle__ClearFollowedObject)> _BSSoundHandle__ClearFollowedObject;
+		};
 	}
 
 	void disable(RE::Projectile* proj, bool restore_speed)
@@ -561,28 +834,71 @@ namespace Followers
 					proj->linearVelocity *= speed / proj->linearVelocity.Length();
 				}
 			}
+			if (is_kinematic(proj))
+				Hooks::FollowingHook::reseat(proj);
 			FenixUtils::Projectile__set_collision_layer(proj, RE::COL_LAYER::kSpell);
 			disable_follower(proj);
+			Slots::release(proj);
+			Registry::remove(proj);
+		}
+	}
+
+	// Keeps followers of the caster within the caps. False if the new one is rejected
+	bool make_room(RE::Projectile* proj, RE::TESObjectREFR* caster, uint32_t ind)
+	{
+		auto& data = Storage::get_data(ind);
+		const auto& settings = Settings::get();
+		if (!data.max_count && !settings.max_followers)
+			return true;
+
+		// In order of applying, the oldest first
+		const auto& caster_pos = caster->GetPosition();
+		std::vector<RE::Projectile*> all;
+		std::vector<EvictionPolicy::Follower> infos;
+		forEachFollower(caster, [proj, &caster_pos, &all, &infos](RE::Projectile* follower) {
+			if (follower != proj) {
+				all.push_back(follower);
+				infos.push_back({ get_follower_ind(follower), follower->GetPosition().GetSquaredDistance(caster_pos) });
+			}
+			return forEachRes::kContinue;
+		});
+
+		EvictionPolicy::Caps caps{ data.max_count, data.eviction, settings.max_followers, settings.followers_eviction };
+		std::vector<size_t> victims;
+		if (!EvictionPolicy::plan(infos, ind, caps, victims))
+			return false;
+
+		for (auto i : victims) {
+			auto victim = all[i];
+			victim->Kill();
+			Slots::release(victim);
+			Registry::remove(victim);
 		}
+		return true;
 	}
 
 	void apply(RE::Projectile* proj, uint32_t ind)
 	{
 		if (proj->IsMissileProjectile() && proj->shooter.get().get() && proj->shooter.get().get()->As<RE::Actor>()) {
 			assert(ind > 0);
-			
+
+			if (!Registry::has(proj) && !make_room(proj, proj->shooter.get().get(), ind))
+				return;
+
 			set_follower_ind(proj, ind);
 
 			auto& data = Storage::get_data(ind);
 
-			if (!data.pattern.isShapeless()) {
-				// TODO: optimize for MC
-				auto new_ind = get_unused_shape_ind(proj);
-				if (new_ind == -1 || new_ind >= Storage::get_data(ind).pattern.getSize())
-					new_ind = 0;
+			if (data.kinematic)
+				FenixUtils::Projectile__set_collision_layer(proj, RE::COL_LAYER::kNonCollidable);
 
-				set_follower_shape_ind(proj, new_ind);
+			Slots::release(proj);
+			if (!data.pattern.isShapeless()) {
+				auto caster = proj->shooter.get().get();
+				set_follower_shape_ind(proj, Slots::claim(proj, caster->formID, ind, data.pattern.getSize()));
 			}
+
+			Registry::add(proj);
 		}
 	}
 
@@ -591,10 +907,16 @@ namespace Followers
 		using namespace Hooks;
 		FollowingHook::Hook();
 		NoCollisionHook::Hook();
+		ReleaseHook::Hook();
 	}
 
 	void clear_keys() { Storage::clear_keys(); }
-	void clear() { Storage::clear(); }
+	void clear()
+	{
+		Storage::clear();
+		Moving::Formations::clear();
+		Registry::rebuild();
+	}
 
 	void init(const std::string& filename, const Json::Value& json_root)
 	{
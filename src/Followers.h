@@ -12,7 +12,22 @@ namespace Followers
 	void apply(RE::Projectile* proj, uint32_t ind);
 	void disable(RE::Projectile* proj, bool restore_speed = true);
 
+	bool is_follower(RE::Projectile* proj);
+
+	// Followers of `a` in the order they were applied. A copy, so it stays valid while followers change
+	std::vector<RE::ProjectileHandle> get_followers(RE::TESObjectREFR* a);
+
 	using forEachRes = RE::BSContainer::ForEachResult;
-	using forEachF = std::function<forEachRes(RE::Projectile* proj)>;
-	void forEachFollower(RE::TESObjectREFR* a, const forEachF& func);
+
+	// Calls `func(RE::Projectile*) -> forEachRes` for every follower of `a`
+	template <typename F>
+	void forEachFollower(RE::TESObjectREFR* a, F&& func)
+	{
+		for (auto& handle : get_followers(a)) {
+			if (auto proj = handle.get().get(); proj && is_follower(proj)) {
+				if (func(proj) == forEachRes::kStop)
+					return;
+			}
+		}
+	}
 }
@@ -1,13 +1,25 @@
 #include "Homing.h"
 #include "JsonUtils.h"
 #include "RuntimeData.h"
+#include "ActorsIndex.h"
+#include "Kinematics.h"
+#include "PerFrame.h"
+#include "Stats.h"
+#include "LOD.h"
+#include "NodeRotation.h"
+#include "TargetScanner.h"
+#include "ReacquireScheduler.h"
+#include "Intercept.h"
+#include "ProportionalNavigation.h"
+#include "PairCache.h"
 
 namespace Homing
 {
 	enum class HomingTypes : uint32_t
 	{
-		ConstSpeed,  // Projectile has constant speed
-		ConstAccel   // Projectile has constant rotation time
+		ConstSpeed,             // Projectile has constant speed
+		ConstAccel,             // Projectile has constant rotation time
+		ProportionalNavigation  // Projectile turns proportionally to the line of sight rotation
 	};
 
 	enum class TargetTypes : uint32_t
@@ -25,16 +37,21 @@ namespace Homing
 	};
 	static constexpr AggressiveTypes AggressiveTypes__DEFAULT = AggressiveTypes::Hostile;
 
+	static constexpr float LOS_CACHE_TIME__DEFAULT = 0.25f;
+
 	struct Data
 	{
-		HomingTypes type: 1;
+		HomingTypes type: 2;
 		TargetTypes target: 2;
 		uint32_t check_LOS: 1;
 		AggressiveTypes hostile_filter: 2;
+		uint32_t async_search: 1;  // valid for target == Nearest
 		float detection_angle;  // valid for target == cursor
-		float val1;             // rotation time (ConstSpeed) or acceleration (ConstAccel)
+		float val1;             // rotation time (ConstSpeed), acceleration (ConstAccel) or gain (ProportionalNavigation)
+		float retarget_interval;  // min time between target searches of a projectile
+		float los_cache_time;     // how long a LOS check between caster and target is reused
 	};
-	static_assert(sizeof(Data) == 12);
+	static_assert(sizeof(Data) == 20);
 
 	struct Storage
 	{
@@ -73,6 +90,7 @@ namespace Homing
 			auto target = JsonUtils::mb_read_field<TargetTypes__DEFAULT>(item, "target");
 			bool check_los = JsonUtils::mb_read_field<false>(item, "checkLOS");
 			auto aggressive = JsonUtils::mb_read_field<AggressiveTypes__DEFAULT>(item, "aggressive");
+			bool async_search = JsonUtils::mb_read_field<false>(item, "asyncSearch");
 
 			float detection_angle = 0.0f;
 			if (target == TargetTypes::Cursor) {
@@ -87,12 +105,19 @@ namespace Homing
 			case HomingTypes::ConstSpeed:
 				val1 = JsonUtils::getFloat(item, "rotationTime");
 				break;
+			case HomingTypes::ProportionalNavigation:
+				val1 = JsonUtils::getFloat(item, "navigationGain");
+				break;
 			default:
 				assert(false);
 				break;
 			}
 
-			data_static.emplace_back(type, target, check_los, aggressive, detection_angle, val1);
+			float retarget_interval = JsonUtils::mb_getFloat(item, "retargetInterval");
+			float los_cache_time = JsonUtils::mb_getFloat<LOS_CACHE_TIME__DEFAULT>(item, "LOSCacheTime");
+
+			data_static.emplace_back(type, target, check_los, aggressive, async_search, detection_angle, val1,
+				retarget_interval, los_cache_time);
 		}
 
 		static void read_json_entry_keys(const std::string& filename, const std::string& key, const Json::Value&)
@@ -112,13 +137,79 @@ namespace Homing
 	void set_homing_ind(RE::Projectile* proj, uint32_t ind) { ::set_homing_ind(proj, ind); }
 	uint32_t get_homing_ind(RE::Projectile* proj) { return ::get_homing_ind(proj); }
 	bool is_homing(RE::Projectile* proj) { return get_homing_ind(proj) != 0; }
-	void disable_homing(RE::Projectile* proj) { set_homing_ind(proj, 0); }
+
+	static ReacquireScheduler scheduler;
+
+	void disable_homing(RE::Projectile* proj)
+	{
+		set_homing_ind(proj, 0);
+		scheduler.remove(proj->formID, proj);
+	}
 
 	namespace Targeting
 	{
 		constexpr float WITHIN_DIST2 = 4.0E7f;
 
-		using FenixUtils::Geom::Actor::AnticipatePos;
+		using Kinematics::AnticipatePos;
+
+		// `IsHostileToActor` of a target to a caster, it resolves factions and is reused for a while.
+		// Pairs named by combat events are dropped at once. Combat targets are plain fields, they are not cached
+		class HostilityCache
+		{
+			static constexpr float HOSTILE_TIME = 2.0f;
+			static constexpr float PRUNE_INTERVAL = 10.0f;
+
+		public:
+			static bool is_aggressive(RE::Actor* target, RE::Actor* caster)
+			{
+				return target->currentCombatTarget.get().get() == caster;
+			}
+
+			static bool is_hostile(RE::Actor* target, RE::Actor* caster)
+			{
+				bool hit;
+				bool ans = cache.get(target->formID, caster->formID, PerFrame::get_time(),
+					[target, caster]() { return target->IsHostileToActor(caster); }, hit);
+				Stats::inc(hit ? Stats::Counter::HostilityHit : Stats::Counter::HostilityMiss);
+				return ans;
+			}
+
+			static void invalidate(RE::TESObjectREFR* a, RE::TESObjectREFR* b)
+			{
+				if (a && b)
+					cache.invalidate(a->formID, b->formID);
+			}
+
+			static void clear() { cache.clear(); }
+
+		private:
+			static inline PairCache<bool> cache{ HOSTILE_TIME, PRUNE_INTERVAL };
+		};
+
+		class CombatEventHandler : public RE::BSTEventSink<RE::TESCombatEvent>
+		{
+		public:
+			static CombatEventHandler* GetSingleton()
+			{
+				static CombatEventHandler singleton;
+				return std::addressof(singleton);
+			}
+
+			RE::BSEventNotifyControl ProcessEvent(const RE::TESCombatEvent* event,
+				RE::BSTEventSource<RE::TESCombatEvent>*) override
+			{
+				if (event)
+					HostilityCache::invalidate(event->actor.get(), event->targetActor.get());
+				return RE::BSEventNotifyControl::kContinue;
+			}
+
+			void enable()
+			{
+				if (auto holder = RE::ScriptEventSourceHolder::GetSingleton()) {
+					holder->AddEventSink<RE::TESCombatEvent>(this);
+				}
+			}
+		};
 
 		bool is_hostile(RE::TESObjectREFR* refr, RE::TESObjectREFR* _caster)
 		{
@@ -126,7 +217,7 @@ namespace Homing
 			auto caster = _caster->As<RE::Actor>();
 			if (!target || !caster)
 				return false;
-			return target->currentCombatTarget.get().get() == caster;
+			return HostilityCache::is_aggressive(target, caster);
 		}
 
 		bool filter_target_base(RE::TESObjectREFR& _refr, RE::TESObjectREFR* caster)
@@ -135,17 +226,60 @@ namespace Homing
 			       _refr.formID != caster->formID;
 		}
 
-		bool filter_target_los(RE::TESObjectREFR& _refr, RE::TESObjectREFR* caster, bool check_los)
+		// Short-lived cache of raycasts between caster and target
+		class LOSCache
+		{
+			static constexpr float PRUNE_INTERVAL = 5.0f;
+
+		public:
+			static bool is_in_los(RE::Actor* caster, RE::Actor* target, float cache_time)
+			{
+				auto now = PerFrame::get_time();
+				prune(now);
+
+				uint64_t key = (static_cast<uint64_t>(caster->formID) << 32) | target->formID;
+				if (auto found = cache.find(key); found != cache.end() && now - found->second.time <= cache_time) {
+					Stats::inc(Stats::Counter::LOSCacheHit);
+					return found->second.visible;
+				}
+
+				Stats::inc(Stats::Counter::LOSRaycast);
+				bool visible = FenixUtils::Geom::Actor::ActorInLOS(caster, target, 100);
+				cache.insert_or_assign(key, Entry{ now, visible });
+				return visible;
+			}
+
+		private:
+			struct Entry
+			{
+				float time;
+				bool visible;
+			};
+
+			static void prune(float now)
+			{
+				if (now - last_prune < PRUNE_INTERVAL)
+					return;
+
+				last_prune = now;
+				std::erase_if(cache, [now](const auto& item) { return now - item.second.time > PRUNE_INTERVAL; });
+			}
+
+			static inline std::unordered_map<uint64_t, Entry> cache;
+			static inline float last_prune = 0.0f;
+		};
+
+		bool filter_target_los(RE::TESObjectREFR& _refr, RE::TESObjectREFR* caster, const Data& data)
 		{
-			return !check_los || !caster->As<RE::Actor>() || !_refr.As<RE::Actor>() ||
-			       FenixUtils::Geom::Actor::ActorInLOS(caster->As<RE::Actor>(), _refr.As<RE::Actor>(), 100);
+			return !data.check_LOS || !caster->As<RE::Actor>() || !_refr.As<RE::Actor>() ||
+			       LOSCache::is_in_los(caster->As<RE::Actor>(), _refr.As<RE::Actor>(), data.los_cache_time);
 		}
 
 		bool filter_target_aggressive(RE::TESObjectREFR& _refr, RE::TESObjectREFR* caster, AggressiveTypes type)
 		{
 			return type == AggressiveTypes::Any || (type == AggressiveTypes::Aggressive && is_hostile(&_refr, caster)) ||
 			       (type == AggressiveTypes::Hostile && _refr.As<RE::Actor>() && caster->As<RE::Actor>() &&
-					   _refr.As<RE::Actor>()->IsHostileToActor(caster->As<RE::Actor>()));
+					   HostilityCache::is_hostile(_refr.As<RE::Actor>(), caster->As<RE::Actor>()));
 		}
 
 		bool filter_target_dist(RE::TESObjectREFR& _refr, const RE::NiPoint3& origin_pos, float within_dist2)
@@ -153,88 +287,99 @@ namespace Homing
 			return origin_pos.GetSquaredDistance(_refr.GetPosition()) < within_dist2;
 		}
 
+		// Everything but LOS, which is checked lazily
 		bool filter_target(RE::TESObjectREFR& _refr, RE::TESObjectREFR* caster, const RE::NiPoint3& origin_pos,
-			AggressiveTypes type, bool check_los, float within_dist2)
+			AggressiveTypes type, float within_dist2)
 		{
 			return filter_target_base(_refr, caster) && filter_target_dist(_refr, origin_pos, within_dist2) &&
-			       filter_target_los(_refr, caster, check_los) && filter_target_aggressive(_refr, caster, type);
+			       filter_target_aggressive(_refr, caster, type);
+		}
+
+		// `candidates` are pairs (dist2, target). They are sorted and raycasted only until the first visible one
+		RE::Actor* get_nearest_in_los(std::vector<std::pair<float, RE::Actor*>>& candidates, RE::TESObjectREFR* caster,
+			const Data& data)
+		{
+			auto less = [](const std::pair<float, RE::Actor*>& a, const std::pair<float, RE::Actor*>& b) {
+				return a.first < b.first;
+			};
+
+			if (!data.check_LOS) {
+				if (candidates.empty())
+					return nullptr;
+				return std::min_element(candidates.begin(), candidates.end(), less)->second;
+			}
+
+			std::sort(candidates.begin(), candidates.end(), less);
+			for (auto [dist2, target] : candidates) {
+				if (filter_target_los(*target, caster, data))
+					return target;
+			}
+			return nullptr;
 		}
 
 		RE::Actor* find_nearest_target(RE::TESObjectREFR* caster, const RE::NiPoint3& origin_pos, const Data& data,
 			float within_dist2 = WITHIN_DIST2)
 		{
-			bool check_los = data.check_LOS;
 			auto hostile_filter = data.hostile_filter;
 
-			float mindist2 = 1.0E15f;
-			RE::TESObjectREFR* refr = nullptr;
-			RE::TES::GetSingleton()->ForEachReference([=, &mindist2, &refr](RE::TESObjectREFR& _refr) {
-				if (filter_target(_refr, caster, origin_pos, hostile_filter, check_los, within_dist2)) {
-					float curdist2 = origin_pos.GetSquaredDistance(_refr.GetPosition());
-					if (curdist2 < mindist2) {
-						mindist2 = curdist2;
-						refr = &_refr;
+			std::vector<std::pair<float, RE::Actor*>> candidates;
+			ActorsIndex::get().forEachInRadius(origin_pos, sqrtf(within_dist2),
+				[=, &candidates](const ActorsIndex::Entry& entry) {
+					if (filter_target(*entry.actor, caster, origin_pos, hostile_filter, within_dist2)) {
+						candidates.push_back({ origin_pos.GetSquaredDistance(entry.pos), entry.actor });
 					}
-				}
-				return RE::BSContainer::ForEachResult::kContinue;
-			});
-
-			if (!refr)
-				return nullptr;
+				});
 
-			return refr->As<RE::Actor>();
+			return get_nearest_in_los(candidates, caster, data);
 		}
 
 		std::vector<RE::Actor*> get_nearest_targets(RE::TESObjectREFR* caster, const RE::NiPoint3& origin_pos, const Data& data,
 			float within_dist2 = WITHIN_DIST2)
 		{
-			bool check_los = data.check_LOS;
 			auto hostile_filter = data.hostile_filter;
 
 			std::vector<RE::Actor*> ans;
 
-			RE::TES::GetSingleton()->ForEachReference([=, &ans](RE::TESObjectREFR& _refr) {
-				if (filter_target(_refr, caster, origin_pos, hostile_filter, check_los, within_dist2)) {
-					ans.push_back(_refr.As<RE::Actor>());
-				}
-				return RE::BSContainer::ForEachResult::kContinue;
-			});
+			ActorsIndex::get().forEachInRadius(origin_pos, sqrtf(within_dist2),
+				[=, &ans, &data](const ActorsIndex::Entry& entry) {
+					if (filter_target(*entry.actor, caster, origin_pos, hostile_filter, within_dist2) &&
+						filter_target_los(*entry.actor, caster, data)) {
+						ans.push_back(entry.actor);
+					}
+				});
 
 			return ans;
 		}
 
 		namespace Cursor
 		{
-			static bool is_anglebetween_less(const RE::NiPoint3& A, const RE::NiPoint3& B1, const RE::NiPoint3& B2,
-				float angle_deg)
+			// Sight cone of the caster, computed once per query
+			struct CursorCone
 			{
-				auto AB1 = B1 - A;
-				auto AB2 = B2 - A;
-				AB1.Unitize();
-				AB2.Unitize();
-				return acos(AB1.Dot(AB2)) < angle_deg / 180.0f * 3.1415926f;
-			}
-
-			static bool is_near_to_cursor(RE::Actor* caster, RE::Actor* target, float angle)
-			{
-				RE::NiPoint3 caster_pos, caster_sight, target_pos;
-
-				caster_pos = FenixUtils::Geom::Actor::CalculateLOSLocation(caster, FenixUtils::LineOfSightLocation::kHead);
-				target_pos = FenixUtils::Geom::Actor::CalculateLOSLocation(target, FenixUtils::LineOfSightLocation::kTorso);
-
-				caster_sight = caster_pos;
-				caster_sight += FenixUtils::Geom::angles2dir(caster->data.angle);
-
-				return is_anglebetween_less(caster_pos, caster_sight, target_pos, angle);
-			}
-
-			bool filter_target_cursor(RE::TESObjectREFR& _refr, RE::Actor* caster, AggressiveTypes type, bool check_los,
-				float angle, float within_dist2)
-			{
-				auto refr = _refr.As<RE::Actor>();
-				return filter_target(_refr, caster, caster->GetPosition(), type, check_los, within_dist2) && refr &&
-				       is_near_to_cursor(caster, refr, angle);
-			}
+				RE::NiPoint3 apex;  // caster's head
+				RE::NiPoint3 dir;   // unit
+				float angle;        // half-angle, radians
+				float cos_max;
+				float apex_height;  // from the caster's position
+
+				CursorCone(RE::Actor* caster, float angle_deg) :
+					apex(FenixUtils::Geom::Actor::CalculateLOSLocation(caster, FenixUtils::LineOfSightLocation::kHead)),
+					dir(FenixUtils::Geom::angles2dir(caster->data.angle)), angle(angle_deg / 180.0f * 3.1415926f),
+					cos_max(cos(angle)), apex_height(apex.GetDistance(caster->GetPosition()))
+				{}
+
+				// Calls `func(const ActorsIndex::Entry&)` for every indexed actor whose torso is in the cone,
+				// at least for all within `radius` from the caster's position
+				template <typename F>
+				void forEachActor(float radius, F&& func) const
+				{
+					using FenixUtils::LineOfSightLocation;
+					auto torso = [](const ActorsIndex::Entry& entry) {
+						return FenixUtils::Geom::Actor::CalculateLOSLocation(entry.actor, LineOfSightLocation::kTorso);
+					};
+					ActorsIndex::get().forEachInCone(apex, dir, cos_max, radius + apex_height, torso, func);
+				}
+			};
 
 			RE::Actor* find_cursor_target(RE::TESObjectREFR* _caster, const Data& data, float within_dist2 = WITHIN_DIST2)
 			{
@@ -242,28 +387,30 @@ namespace Homing
 					return nullptr;
 
 				auto caster = _caster->As<RE::Actor>();
-				std::vector<std::pair<RE::Actor*, float>> targets;
-
-				auto angle = data.detection_angle;
-				bool check_los = data.check_LOS;
+				CursorCone cone(caster, data.detection_angle);
 				auto hostile_filter = data.hostile_filter;
+				const auto& caster_pos = caster->GetPosition();
+
+				// Without LOS the nearest one is kept as we go, otherwise all are needed for the lazy LOS check
+				RE::Actor* best = nullptr;
+				float best_dist2 = std::numeric_limits<float>::max();
+				std::vector<std::pair<float, RE::Actor*>> candidates;
+
+				cone.forEachActor(sqrtf(within_dist2),
+					[=, &data, &best, &best_dist2, &candidates](const ActorsIndex::Entry& entry) {
+						if (!filter_target(*entry.actor, caster, caster_pos, hostile_filter, within_dist2))
+							return;
+
+						float dist2 = caster_pos.GetSquaredDistance(entry.pos);
+						if (data.check_LOS) {
+							candidates.push_back({ dist2, entry.actor });
+						} else if (dist2 < best_dist2) {
+							best_dist2 = dist2;
+							best = entry.actor;
+						}
+					});
 
-				RE::TES::GetSingleton()->ForEachReference([=, &targets](RE::TESObjectREFR& _refr) {
-					if (filter_target_cursor(_refr, caster, hostile_filter, check_los, angle, within_dist2)) {
-						targets.push_back(
-							{ _refr.As<RE::Actor>(), caster->GetPosition().GetSquaredDistance(_refr.GetPosition()) });
-					}
-					return RE::BSContainer::ForEachResult::kContinue;
-				});
-
-				if (!targets.size())
-					return nullptr;
-
-				return (*std::min_element(targets.begin(), targets.end(),
-							[](const std::pair<RE::Actor*, float>& a, const std::pair<RE::Actor*, float>& b) {
-								return a.second < b.second;
-							}))
-				    .first;
+				return data.check_LOS ? get_nearest_in_los(candidates, caster, data) : best;
 			}
 
 			std::vector<RE::Actor*> get_cursor_targets(RE::TESObjectREFR* _caster, const Data& data,
@@ -275,57 +422,135 @@ namespace Homing
 					return ans;
 
 				auto caster = _caster->As<RE::Actor>();
-
-				auto angle = data.detection_angle;
-				bool check_los = data.check_LOS;
+				CursorCone cone(caster, data.detection_angle);
 				auto hostile_filter = data.hostile_filter;
+				const auto& caster_pos = caster->GetPosition();
 
-				RE::TES::GetSingleton()->ForEachReference([=, &ans](RE::TESObjectREFR& _refr) {
-					if (filter_target_cursor(_refr, caster, hostile_filter, check_los, angle, within_dist2)) {
-						auto refr = _refr.As<RE::Actor>();
-						if (caster->GetPosition().GetSquaredDistance(refr->GetPosition()) < within_dist2) {
-							ans.push_back(refr);
-						}
+				cone.forEachActor(sqrtf(within_dist2), [=, &caster_pos, &ans, &data](const ActorsIndex::Entry& entry) {
+					if (filter_target(*entry.actor, caster, caster_pos, hostile_filter, within_dist2) &&
+						filter_target_los(*entry.actor, caster, data)) {
+						ans.push_back(entry.actor);
 					}
-					return RE::BSContainer::ForEachResult::kContinue;
 				});
 
 				return ans;
 			}
 		}
 
-		RE::Actor* findTarget(RE::TESObjectREFR* origin, const Data& data)
+		// Targets found in the current frame. All projectiles that ask the same question share one answer
+		class TargetsCache
 		{
-			auto proj = origin->As<RE::Projectile>();
+			static constexpr float ORIGIN_BUCKET_SIZE = 256.0f;
 
-			if (proj) {
-				auto target = proj->desiredTarget.get().get();
-				if (target)
-					return target->As<RE::Actor>();
+		public:
+			struct Key
+			{
+				RE::FormID caster;
+				uint32_t homing_ind;
+				int32_t x, y, z;  // origin bucket, zero for cursor
+				float within_dist2;
+
+				bool operator==(const Key&) const = default;
+			};
+
+			static Key get_key(RE::TESObjectREFR* caster, uint32_t homing_ind, const RE::NiPoint3* origin, float within_dist2)
+			{
+				Key key{ caster->formID, homing_ind, 0, 0, 0, within_dist2 };
+				if (origin) {
+					key.x = static_cast<int32_t>(std::floor(origin->x / ORIGIN_BUCKET_SIZE));
+					key.y = static_cast<int32_t>(std::floor(origin->y / ORIGIN_BUCKET_SIZE));
+					key.z = static_cast<int32_t>(std::floor(origin->z / ORIGIN_BUCKET_SIZE));
+				}
+				return key;
 			}
 
-			auto caster = proj ? proj->shooter.get().get() : origin;
-			if (!caster)
+			// Returns cached target (maybe nullptr) or calls `find()` and caches its answer
+			template <typename F>
+			static RE::Actor* get(const Key& key, F find)
+			{
+				if (auto cur_frame = PerFrame::get_frame(); frame != cur_frame) {
+					frame = cur_frame;
+					targets.clear();
+				}
+
+				if (auto found = targets.find(key); found != targets.end()) {
+					Stats::inc(Stats::Counter::TargetCacheHit);
+					return found->second;
+				}
+
+				Stats::inc(Stats::Counter::TargetCacheMiss);
+				auto ans = find();
+				targets.insert({ key, ans });
+				return ans;
+			}
+
+		private:
+			struct KeyHash
+			{
+				size_t operator()(const Key& key) const
+				{
+					size_t ans = std::hash<uint32_t>()(key.caster);
+					auto combine = [&ans](size_t val) { ans ^= val + 0x9e3779b9 + (ans << 6) + (ans >> 2); };
+					combine(key.homing_ind);
+					combine(static_cast<uint32_t>(key.x));
+					combine(static_cast<uint32_t>(key.y));
+					combine(static_cast<uint32_t>(key.z));
+					combine(std::hash<float>()(key.within_dist2));
+					return ans;
+				}
+			};
+
+			static inline std::unordered_map<Key, RE::Actor*, KeyHash> targets;
+			static inline uint32_t frame = 0;
+		};
+
+		// Captured target if it is still valid, drops it otherwise. Cheap, used every frame
+		RE::Actor* get_desired_target(RE::Projectile* proj)
+		{
+			auto target = proj->desiredTarget.get().get();
+			if (!target)
 				return nullptr;
 
-			if (auto caster_npc = caster->As<RE::Actor>(); caster_npc && !caster_npc->IsPlayerRef()) {
-				return caster_npc->currentCombatTarget.get().get();
+			if (target->IsDead() || target->IsDisabled()) {
+				proj->desiredTarget = {};
+				return nullptr;
 			}
 
+			return target->As<RE::Actor>();
+		}
+
+		float get_within_dist2(RE::Projectile* proj)
+		{
+			return proj && (proj->IsFlameProjectile() || proj->IsBeamProjectile()) ? proj->range * proj->range : WITHIN_DIST2;
+		}
+
+		// Costly part: a search among actors around for player (or non-actor) casters
+		RE::Actor* searchTarget(RE::TESObjectREFR* origin, RE::TESObjectREFR* caster, uint32_t homing_ind)
+		{
+			auto proj = origin->As<RE::Projectile>();
+
+			const auto& data = Storage::get_data(homing_ind);
 			auto target_type = data.target;
-			float within_dist =
-				proj && (proj->IsFlameProjectile() || proj->IsBeamProjectile()) ? proj->range * proj->range : WITHIN_DIST2;
+			float within_dist = get_within_dist2(proj);
 
-			RE::TESObjectREFR* refr;
+			RE::Actor* refr;
 			switch (target_type) {
 			case TargetTypes::Nearest:
 				{
-					refr = find_nearest_target(caster, (proj ? proj : caster)->GetPosition(), data, within_dist);
+					const auto& origin_pos = (proj ? proj : caster)->GetPosition();
+					auto key = TargetsCache::get_key(caster, homing_ind, &origin_pos, within_dist);
+					refr = TargetsCache::get(key, [caster, &origin_pos, &data, within_dist]() {
+						return find_nearest_target(caster, origin_pos, data, within_dist);
+					});
 					break;
 				}
 			case TargetTypes::Cursor:
-				refr = Cursor::find_cursor_target(caster, data, within_dist);
-				break;
+				{
+					auto key = TargetsCache::get_key(caster, homing_ind, nullptr, within_dist);
+					refr = TargetsCache::get(key,
+						[caster, &data, within_dist]() { return Cursor::find_cursor_target(caster, data, within_dist); });
+					break;
+				}
 			default:
 				refr = nullptr;
 				break;
@@ -340,54 +565,117 @@ namespace Homing
 
 			if (proj)
 				proj->desiredTarget = refr->GetHandle();
-			return refr->As<RE::Actor>();
+			return refr;
 		}
-	}
 
-	namespace Moving
-	{
-		bool get_shoot_dir(RE::Projectile* proj, RE::Actor* target, float dtime, RE::NiPoint3& ans)
+		RE::Actor* findTarget(RE::TESObjectREFR* origin, uint32_t homing_ind)
 		{
-			RE::NiPoint3 target_dir;
-			target->GetLinearVelocity(target_dir);
-			double target_speed = target_dir.Length();
+			auto proj = origin->As<RE::Projectile>();
 
-			double proj_speed = FenixUtils::Projectile__GetSpeed(proj);
+			if (proj) {
+				if (auto target = get_desired_target(proj))
+					return target;
+			}
 
-			auto target_pos = Targeting::AnticipatePos(target, dtime);
-			auto strait_dir = target_pos - proj->GetPosition();
+			auto caster = proj ? proj->shooter.get().get() : origin;
+			if (!caster)
+				return nullptr;
 
-			double a = proj_speed * proj_speed - target_speed * target_speed;
+			if (auto caster_npc = caster->As<RE::Actor>(); caster_npc && !caster_npc->IsPlayerRef()) {
+				return caster_npc->currentCombatTarget.get().get();
+			}
 
-			double strait_len = strait_dir.Unitize();
-			double c = -(strait_len * strait_len);
-			double b;
+			return searchTarget(origin, caster, homing_ind);
+		}
 
-			if (target_speed > 0.0001) {
-				target_dir.Unitize();
-				double cos_phi = -target_dir.Dot(strait_dir);
-				b = 2 * strait_len * target_speed * cos_phi;
-			} else {
-				b = 0.0;
+		// Candidates are scanned by TargetScanner a frame before, here they are only validated.
+		// The scan already skips actors that fail filter_target_base and the hostility filter
+		RE::Actor* updateTargetAsync(RE::Projectile* proj, RE::TESObjectREFR* caster, uint32_t homing_ind, const Data& data,
+			bool& keep_homing)
+		{
+			float within_dist2 = get_within_dist2(proj);
+
+			if (auto candidates = TargetScanner::take(proj->formID)) {
+				const auto& origin_pos = proj->GetPosition();
+				for (auto& handle : *candidates) {
+					auto target = handle.get().get();
+					if (target && filter_target(*target, caster, origin_pos, data.hostile_filter, within_dist2) &&
+						filter_target_los(*target, caster, data)) {
+						proj->desiredTarget = handle;
+						return target;
+					}
+				}
+
+				// The scan is truncated, farther visible targets may exist
+				RE::Actor* target = nullptr;
+				if (candidates->size() >= TargetScanner::MAX_CANDIDATES)
+					target = searchTarget(proj, caster, homing_ind);
+
+				// Without interval nothing to wait for
+				if (!target && data.retarget_interval == 0.0f)
+					keep_homing = false;
+				return target;
 			}
 
-			double D = b * b - 4 * a * c;
-			if (D < 0)
-				return false;
+			if (TargetScanner::is_waiting(proj->formID))
+				return nullptr;
 
-			D = sqrt(D);
-			double t1 = (-b + D) / a * 0.5;
-			double t2 = (-b - D) / a * 0.5;
+			if (scheduler.try_acquire(proj->formID, proj, data.retarget_interval, PerFrame::get_frame(), PerFrame::get_time())) {
+				auto type = data.hostile_filter;
+				auto filter_key = (static_cast<uint64_t>(caster->formID) << 32) | static_cast<uint32_t>(type);
+				TargetScanner::request(proj->formID, proj->GetPosition(), within_dist2, filter_key,
+					[caster_handle = caster->GetHandle(), type](RE::Actor* actor) {
+						auto caster = caster_handle.get().get();
+						return caster && filter_target_base(*actor, caster) && filter_target_aggressive(*actor, caster, type);
+					});
+			}
+			return nullptr;
+		}
 
-			if (t1 <= 0 && t2 <= 0)
-				return false;
+		// Per-frame version of findTarget: searches only on projectile's time slice.
+		// `keep_homing` is false if the projectile should stop homing.
+		RE::Actor* updateTarget(RE::Projectile* proj, uint32_t homing_ind, bool& keep_homing)
+		{
+			keep_homing = true;
+
+			if (auto target = get_desired_target(proj))
+				return target;
+
+			auto caster = proj->shooter.get().get();
+			if (!caster) {
+				keep_homing = false;
+				return nullptr;
+			}
+
+			if (auto caster_npc = caster->As<RE::Actor>(); caster_npc && !caster_npc->IsPlayerRef()) {
+				auto target = caster_npc->currentCombatTarget.get().get();
+				keep_homing = target != nullptr;
+				return target;
+			}
+
+			const auto& data = Storage::get_data(homing_ind);
+			if (data.async_search && data.target == TargetTypes::Nearest)
+				return updateTargetAsync(proj, caster, homing_ind, data, keep_homing);
+
+			if (!scheduler.try_acquire(proj->formID, proj, data.retarget_interval, PerFrame::get_frame(), PerFrame::get_time()))
+				return nullptr;
+
+			auto target = searchTarget(proj, caster, homing_ind);
 
-			double t = t1;
-			if (t2 > 0 && t2 < t1)
-				t = t2;
+			// Without interval nothing to wait for
+			if (!target && data.retarget_interval == 0.0f)
+				keep_homing = false;
 
-			ans = target_dir * (float)target_speed + strait_dir * (float)(strait_len / t);
-			return true;
+			return target;
+		}
+	}
+
+	namespace Moving
+	{
+		bool get_shoot_dir(RE::Projectile* proj, RE::Actor* target, float dtime, RE::NiPoint3& ans)
+		{
+			return Intercept::solve(proj->GetPosition(), FenixUtils::Projectile__GetSpeed(proj),
+				Targeting::AnticipatePos(target, dtime), Kinematics::get(target).vel, ans);
 		}
 
 		// constant speed, limited rotation angle
@@ -406,8 +694,9 @@ namespace Homing
 				FenixUtils::Geom::rotateVel(proj->linearVelocity, get_rotation_speed(proj, param) * dtime, final_dir);
 		}
 
-		// constant acceleration length
-		void change_direction_2(RE::Projectile* proj, [[maybe_unused]] float dtime, const RE::NiPoint3& final_vel, float param)
+		// constant acceleration length. The acceleration is given per frame,
+		// `frames` is how many frames the step covers (more than 1 if LOD skipped some)
+		void change_direction_2(RE::Projectile* proj, float frames, const RE::NiPoint3& final_vel, float param)
 		{
 			auto get_acceleration = []([[maybe_unused]] RE::Projectile* proj, float param) {
 				// param1 / 10 = acceleration vector length
@@ -421,40 +710,205 @@ namespace Homing
 			V *= speed;
 			V -= proj->linearVelocity;
 			V.Unitize();
-			V *= get_acceleration(proj, param);
+			V *= get_acceleration(proj, param) * frames;
 			speed = FenixUtils::Projectile__GetSpeed(proj);
 			proj->linearVelocity += V;
 			float newspeed = proj->linearVelocity.Length();
 			proj->linearVelocity *= speed / newspeed;
 		}
 
-		void change_direction_linVel(RE::Projectile* proj, float dtime)
+		// proportional navigation, no intercept point is needed
+		void change_direction_3(RE::Projectile* proj, float dtime, const RE::NiPoint3& target_pos,
+			const RE::NiPoint3& target_vel, float gain)
+		{
+			ProportionalNavigation::steer(proj->GetPosition(), proj->linearVelocity, target_pos, target_vel, gain, dtime);
+		}
+
+		// `steer_dtime` is `dtime` scaled by LOD for the frames it skipped
+		void steer(RE::Projectile* proj, float dtime, float steer_dtime, const Data& data, const RE::NiPoint3& final_vel)
+		{
+			auto val1 = data.val1;
+			auto type = data.type;
+			switch (type) {
+			case HomingTypes::ConstSpeed:
+				change_direction_1(proj, steer_dtime, final_vel, val1);
+				break;
+			case HomingTypes::ConstAccel:
+				change_direction_2(proj, dtime > 0.0f ? steer_dtime / dtime : 1.0f, final_vel, val1);
+				break;
+			default:
+				break;
+			}
+		}
+
+		// `steer_dtime` is `dtime` scaled by LOD for the frames it skipped
+		void steer_to_target(RE::Projectile* proj, RE::Actor* target, float dtime, float steer_dtime)
 		{
 			RE::NiPoint3 final_vel;
 			auto& data = Storage::get_data(get_homing_ind(proj));
-			if (auto target = Targeting::findTarget(proj, data); target && get_shoot_dir(proj, target, dtime, final_vel)) {
-				auto val1 = data.val1;
-				auto type = data.type;
-				switch (type) {
-				case HomingTypes::ConstSpeed:
-					change_direction_1(proj, dtime, final_vel, val1);
+			if (data.type == HomingTypes::ProportionalNavigation) {
+				change_direction_3(proj, steer_dtime, Kinematics::AnticipatePos(target, dtime), Kinematics::get(target).vel,
+					data.val1);
+			} else if (get_shoot_dir(proj, target, dtime, final_vel)) {
+				steer(proj, dtime, steer_dtime, data, final_vel);
+			} else {
+				disable_homing(proj);
+			}
+		}
+
+		void change_direction_linVel_scalar(RE::Projectile* proj, float dtime, float steer_dtime)
+		{
+			bool keep_homing;
+			auto target = Targeting::updateTarget(proj, get_homing_ind(proj), keep_homing);
+			if (!target) {
+				if (!keep_homing)
+					disable_homing(proj);
+				return;
+			}
+
+			steer_to_target(proj, target, dtime, steer_dtime);
+		}
+
+		// Homing projectiles of a frame are gathered on the first homing update in the frame.
+		// Targets and intercept velocities are computed for all of them at once, every update then only steers its projectile
+		namespace Batch
+		{
+			using Intercept::State;
+
+			struct Item
+			{
+				RE::Projectile* proj;  // only compared, never dereferenced
+				RE::NiPoint3 pos;
+				RE::ActorHandle target;  // resolved once in build(), empty if none
+			};
+
+			static std::vector<Item> items;
+			static std::unordered_map<RE::FormID, uint32_t> slots;
+			static Intercept::Buffers soa;
+			static uint32_t batch_frame = 0;
+			static float batch_dtime = 0.0f;
+
+			static void gather(const RE::BSTArray<RE::ProjectileHandle>& arr)
+			{
+				for (auto& handle : arr) {
+					if (auto proj = handle.get().get(); proj && is_homing(proj) && !LOD::is_skipped(proj)) {
+						slots.insert_or_assign(proj->formID, static_cast<uint32_t>(items.size()));
+						items.push_back({ proj, proj->GetPosition(), {} });
+					}
+				}
+			}
+
+			static void build(float dtime)
+			{
+				items.clear();
+				slots.clear();
+
+				auto manager = RE::Projectile::Manager::GetSingleton();
+				gather(manager->limited);
+				gather(manager->unlimited);
+
+				soa.resize(items.size());
+				for (uint32_t i = 0; i < items.size(); i++) {
+					auto proj = items[i].proj;
+
+					bool keep_homing;
+					auto target = Targeting::updateTarget(proj, get_homing_ind(proj), keep_homing);
+					if (!target) {
+						soa.state[i] = keep_homing ? State::NoTarget : State::Disable;
+						continue;
+					}
+					items[i].target = target->GetHandle();
+
+					const auto& pos = items[i].pos;
+					auto target_pos = Kinematics::AnticipatePos(target, dtime);
+					const auto& target_vel = Kinematics::get(target).vel;
+
+					soa.px[i] = pos.x;
+					soa.py[i] = pos.y;
+					soa.pz[i] = pos.z;
+					soa.tx[i] = target_pos.x;
+					soa.ty[i] = target_pos.y;
+					soa.tz[i] = target_pos.z;
+					soa.vx[i] = target_vel.x;
+					soa.vy[i] = target_vel.y;
+					soa.vz[i] = target_vel.z;
+					soa.speed[i] = FenixUtils::Projectile__GetSpeed(proj);
+					soa.state[i] = Storage::get_data(get_homing_ind(proj)).type == HomingTypes::ProportionalNavigation ?
+					                   State::Navigation :
+					                   State::Ok;
+				}
+
+				Intercept::solve(soa);
+			}
+
+			// Returns false if the projectile is not in the batch and must be processed by the usual path
+			bool change_direction_linVel(RE::Projectile* proj, float dtime, float steer_dtime)
+			{
+				if (auto frame = PerFrame::get_frame(); batch_frame != frame) {
+					batch_frame = frame;
+					batch_dtime = dtime;
+					build(dtime);
+				}
+
+				auto found = slots.find(proj->formID);
+				if (found == slots.end())
+					return false;
+
+				auto i = found->second;
+				const auto& item = items[i];
+				if (item.proj != proj)
+					return false;
+
+				// Changed since gathering or degenerate: the target is already resolved, only the steering is scalar
+				if (dtime != batch_dtime || item.pos != proj->GetPosition() || soa.state[i] == State::Scalar) {
+					Stats::inc(Stats::Counter::HomingScalar);
+					if (auto target = item.target.get())
+						steer_to_target(proj, target.get(), dtime, steer_dtime);
+					else if (soa.state[i] == State::Disable)
+						disable_homing(proj);
+					return true;
+				}
+
+				switch (soa.state[i]) {
+				case State::Ok:
+					steer(proj, dtime, steer_dtime, Storage::get_data(get_homing_ind(proj)),
+						{ soa.fx[i], soa.fy[i], soa.fz[i] });
+					break;
+				case State::Navigation:
+					change_direction_3(proj, steer_dtime, { soa.tx[i], soa.ty[i], soa.tz[i] },
+						{ soa.vx[i], soa.vy[i], soa.vz[i] }, Storage::get_data(get_homing_ind(proj)).val1);
 					break;
-				case HomingTypes::ConstAccel:
-					change_direction_2(proj, dtime, final_vel, val1);
+				case State::NoTarget:
 					break;
-				default:
+				case State::Disable:
+					disable_homing(proj);
+					break;
+				case State::Scalar:
 					break;
 				}
-			} else {
-				disable_homing(proj);
+
+				Stats::inc(Stats::Counter::HomingBatched);
+				return true;
+			}
+		}
+
+		void change_direction_linVel(RE::Projectile* proj, float dtime, float steer_dtime)
+		{
+			if (!Batch::change_direction_linVel(proj, dtime, steer_dtime)) {
+				Stats::inc(Stats::Counter::HomingScalar);
+				change_direction_linVel_scalar(proj, dtime, steer_dtime);
 			}
 		}
 
 		void change_direction(RE::Projectile* proj, RE::NiPoint3*, float dtime)
 		{
-			change_direction_linVel(proj, dtime);
+			float steer_dtime = dtime;
+			if (!LOD::update_now(proj, steer_dtime))
+				return;
 
-			FenixUtils::Geom::Projectile::update_node_rotation(proj);
+			change_direction_linVel(proj, dtime, steer_dtime);
+
+			NodeRotation::update(proj);
 
 #ifdef DEBUG
 			{
@@ -583,16 +1037,13 @@ namespace Homing
 
 					if (auto ind = get_cursor_ind(a)) {
 						const auto& data = Storage::get_data(ind);
-						float alpha_max = data.detection_angle;
-						alpha_max = alpha_max / 180.0f * 3.1415926f;
+						Targeting::Cursor::CursorCone cone(a, data.detection_angle);
 
-						RE::NiPoint3 origin, caster_dir;
-						origin = FenixUtils::Geom::Actor::CalculateLOSLocation(a, FenixUtils::LineOfSightLocation::kHead);
+						RE::NiPoint3 origin = cone.apex, caster_dir = cone.dir;
 
 						const float circle_dist = 2000;
-						caster_dir = FenixUtils::Geom::angles2dir(a->data.angle);
 
-						float circle_r = circle_dist * tan(alpha_max);
+						float circle_r = circle_dist * tan(cone.angle);
 						RE::NiPoint3 right_dir = RE::NiPoint3(0, 0, -1).UnitCross(caster_dir);
 						if (right_dir.SqrLength() == 0)
 							right_dir = { 1, 0, 0 };
@@ -634,10 +1085,8 @@ namespace Homing
 			return;
 
 		if (proj->IsMissileProjectile() || proj->IsBeamProjectile()) {
-			auto& data = Storage::get_data(ind);
-
 			if (!targetOverride)
-				targetOverride = Targeting::findTarget(proj, data);
+				targetOverride = Targeting::findTarget(proj, ind);
 
 			if (targetOverride) {
 				FenixUtils::Geom::Projectile::aimToPoint(proj, Targeting::AnticipatePos(targetOverride));
@@ -664,10 +1113,8 @@ namespace Homing
 			set_homing_ind(proj, ind);
 		}
 
-		auto& data = Storage::get_data(ind);
-
 		if (!targetOverride)
-			targetOverride = Targeting::findTarget(proj, data);
+			targetOverride = Targeting::findTarget(proj, ind);
 		else
 			proj->desiredTarget = targetOverride->GetHandle();
 
@@ -688,6 +1135,7 @@ namespace Homing
 
 		HomingFlamesHook::Hook();
 		HomingMissilesHook::Hook();
+		Targeting::CombatEventHandler::GetSingleton()->enable();
 
 #ifdef DEBUG
 		Debug::CursorDetectedHook::Hook();
@@ -695,7 +1143,12 @@ namespace Homing
 #endif
 	}
 
-	void clear() { Storage::clear(); }
+	void clear()
+	{
+		Storage::clear();
+		scheduler.clear();
+		Targeting::HostilityCache::clear();
+	}
 	void clear_keys() { Storage::clear_keys(); }
 
 	void init(const std::string& filename, const Json::Value& json_root)
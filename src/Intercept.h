@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <xmmintrin.h>
+
+// Intercept velocity: the velocity of given speed that meets a target moving straight with constant velocity.
+// Has no game dependencies, `Vec` is any type with float members x, y, z
+namespace Intercept
+{
+	// False if the target can not be reached
+	template <typename Vec>
+	bool solve(const Vec& pos, double proj_speed, const Vec& target_pos, const Vec& target_vel, Vec& ans)
+	{
+		double sx = target_pos.x - pos.x, sy = target_pos.y - pos.y, sz = target_pos.z - pos.z;
+		double vx = target_vel.x, vy = target_vel.y, vz = target_vel.z;
+		double target_speed = std::sqrt(vx * vx + vy * vy + vz * vz);
+
+		double a = proj_speed * proj_speed - target_speed * target_speed;
+
+		double strait_len = std::sqrt(sx * sx + sy * sy + sz * sz);
+		if (strait_len > 0.0) {
+			sx /= strait_len;
+			sy /= strait_len;
+			sz /= strait_len;
+		}
+		double c = -(strait_len * strait_len);
+		double b;
+
+		if (target_speed > 0.0001) {
+			double cos_phi = -(vx * sx + vy * sy + vz * sz) / target_speed;
+			b = 2 * strait_len * target_speed * cos_phi;
+		} else {
+			b = 0.0;
+		}
+
+		double D = b * b - 4 * a * c;
+		if (D < 0)
+			return false;
+
+		D = std::sqrt(D);
+		double t1 = (-b + D) / a * 0.5;
+		double t2 = (-b - D) / a * 0.5;
+
+		if (t1 <= 0 && t2 <= 0)
+			return false;
+
+		double t = t1;
+		if (t2 > 0 && t2 < t1)
+			t = t2;
+
+		double k = strait_len / t;
+		ans.x = static_cast<float>(vx + sx * k);
+		ans.y = static_cast<float>(vy + sy * k);
+		ans.z = static_cast<float>(vz + sz * k);
+		return true;
+	}
+
+	enum class State : uint8_t
+	{
+		Ok,
+		Navigation,  // ProportionalNavigation, needs no intercept
+		NoTarget,    // wait for a target
+		Disable,     // target is lost or unreachable
+		Scalar,      // degenerate or changed since gathering, computed by the usual path
+	};
+
+	// Structure of arrays, sizes are padded to the SIMD width
+	struct Buffers
+	{
+		static constexpr size_t WIDTH = 4;
+
+		std::vector<float> px, py, pz;  // projectile position
+		std::vector<float> tx, ty, tz;  // anticipated target position
+		std::vector<float> vx, vy, vz;  // target velocity
+		std::vector<float> speed;       // projectile speed
+		std::vector<float> fx, fy, fz;  // result, velocity to reach the target
+		std::vector<State> state;
+
+		void resize(size_t n)
+		{
+			n = (n + WIDTH - 1) / WIDTH * WIDTH;
+			for (auto v : { &px, &py, &pz, &tx, &ty, &tz, &vx, &vy, &vz, &speed, &fx, &fy, &fz }) {
+				v->assign(n, 0.0f);
+			}
+			state.assign(n, State::Scalar);
+		}
+	};
+
+	// Same as solve, 4 lanes at once in float. Lanes in State::Ok get the result,
+	// or become Disable if unreachable, or Scalar if degenerate
+	inline void solve(Buffers& soa)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 four = _mm_set1_ps(4.0f);
+		const __m128 minus_two = _mm_set1_ps(-2.0f);
+		const __m128 min_speed2 = _mm_set1_ps(0.0001f * 0.0001f);
+
+		auto dot = [](__m128 x0, __m128 y0, __m128 z0, __m128 x1, __m128 y1, __m128 z1) {
+			return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_mul_ps(z0, z1));
+		};
+
+		for (size_t i = 0; i < soa.state.size(); i += Buffers::WIDTH) {
+			__m128 vx = _mm_loadu_ps(&soa.vx[i]);
+			__m128 vy = _mm_loadu_ps(&soa.vy[i]);
+			__m128 vz = _mm_loadu_ps(&soa.vz[i]);
+
+			__m128 sx = _mm_sub_ps(_mm_loadu_ps(&soa.tx[i]), _mm_loadu_ps(&soa.px[i]));
+			__m128 sy = _mm_sub_ps(_mm_loadu_ps(&soa.ty[i]), _mm_loadu_ps(&soa.py[i]));
+			__m128 sz = _mm_sub_ps(_mm_loadu_ps(&soa.tz[i]), _mm_loadu_ps(&soa.pz[i]));
+
+			__m128 len2 = dot(sx, sy, sz, sx, sy, sz);
+			__m128 len = _mm_sqrt_ps(len2);
+			__m128 inv_len = _mm_div_ps(_mm_set1_ps(1.0f), len);  // inf lanes are marked as degenerate
+			sx = _mm_mul_ps(sx, inv_len);
+			sy = _mm_mul_ps(sy, inv_len);
+			sz = _mm_mul_ps(sz, inv_len);
+
+			__m128 proj_speed = _mm_loadu_ps(&soa.speed[i]);
+			__m128 target_speed2 = dot(vx, vy, vz, vx, vy, vz);
+
+			__m128 a = _mm_sub_ps(_mm_mul_ps(proj_speed, proj_speed), target_speed2);
+			__m128 c = _mm_sub_ps(zero, len2);
+			// b = 2 * len * target_speed * cos_phi, cos_phi = -dot(target_dir, strait_dir)
+			__m128 b = _mm_mul_ps(_mm_mul_ps(minus_two, len), dot(vx, vy, vz, sx, sy, sz));
+			b = _mm_and_ps(b, _mm_cmpgt_ps(target_speed2, min_speed2));
+
+			__m128 D = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(four, _mm_mul_ps(a, c)));
+			__m128 has_root = _mm_cmpge_ps(D, zero);
+			D = _mm_sqrt_ps(_mm_max_ps(D, zero));
+
+			__m128 nb = _mm_sub_ps(zero, b);
+			__m128 t1 = _mm_div_ps(_mm_mul_ps(_mm_add_ps(nb, D), half), a);
+			__m128 t2 = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(nb, D), half), a);
+
+			__m128 use_t2 = _mm_and_ps(_mm_cmpgt_ps(t2, zero), _mm_cmplt_ps(t2, t1));
+			__m128 t = _mm_or_ps(_mm_and_ps(use_t2, t2), _mm_andnot_ps(use_t2, t1));
+			__m128 has_time = _mm_or_ps(_mm_cmpgt_ps(t1, zero), _mm_cmpgt_ps(t2, zero));
+
+			__m128 k = _mm_div_ps(len, t);
+			_mm_storeu_ps(&soa.fx[i], _mm_add_ps(vx, _mm_mul_ps(sx, k)));
+			_mm_storeu_ps(&soa.fy[i], _mm_add_ps(vy, _mm_mul_ps(sy, k)));
+			_mm_storeu_ps(&soa.fz[i], _mm_add_ps(vz, _mm_mul_ps(sz, k)));
+
+			int ok = _mm_movemask_ps(_mm_and_ps(has_root, has_time));
+			int degenerate = _mm_movemask_ps(_mm_or_ps(_mm_cmpeq_ps(len, zero), _mm_cmpeq_ps(a, zero)));
+			for (size_t j = 0; j < Buffers::WIDTH; j++) {
+				if (soa.state[i + j] != State::Ok)
+					continue;
+
+				if ((degenerate >> j) & 1)
+					soa.state[i + j] = State::Scalar;
+				else if (!((ok >> j) & 1))
+					soa.state[i + j] = State::Disable;
+			}
+		}
+	}
+}
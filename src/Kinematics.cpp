@@ -0,0 +1,54 @@
+#include "Kinematics.h"
+#include "PerFrame.h"
+#include "Stats.h"
+
+namespace Kinematics
+{
+	struct Entry
+	{
+		Data data;
+		float dtime;  // projectiles of a frame usually share dtime, so one more slot is enough
+		RE::NiPoint3 anticipated_dtime;
+	};
+
+	static std::unordered_map<RE::FormID, Entry> table;
+	static uint32_t table_frame = 0;
+
+	static Entry& get_entry(RE::Actor* a)
+	{
+		if (auto frame = PerFrame::get_frame(); table_frame != frame) {
+			table_frame = frame;
+			table.clear();
+		}
+
+		auto [found, inserted] = table.try_emplace(a->formID);
+		auto& entry = found->second;
+		if (inserted) {
+			Stats::inc(Stats::Counter::KinematicsMiss);
+
+			a->GetLinearVelocity(entry.data.vel);
+			entry.data.speed = entry.data.vel.Length();
+			entry.data.anticipated = FenixUtils::Geom::Actor::AnticipatePos(a);
+			entry.dtime = 0.0f;
+			entry.anticipated_dtime = entry.data.anticipated;
+		} else {
+			Stats::inc(Stats::Counter::KinematicsHit);
+		}
+		return entry;
+	}
+
+	const Data& get(RE::Actor* a) { return get_entry(a).data; }
+
+	RE::NiPoint3 AnticipatePos(RE::Actor* a, float dtime)
+	{
+		auto& entry = get_entry(a);
+		if (dtime == 0.0f)
+			return entry.data.anticipated;
+
+		if (entry.dtime != dtime) {
+			entry.dtime = dtime;
+			entry.anticipated_dtime = FenixUtils::Geom::Actor::AnticipatePos(a, dtime);
+		}
+		return entry.anticipated_dtime;
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace Kinematics
+{
+	// Motion of an actor, computed once per frame
+	struct Data
+	{
+		RE::NiPoint3 vel;
+		float speed;
+		RE::NiPoint3 anticipated;  // AnticipatePos with dtime == 0
+	};
+
+	const Data& get(RE::Actor* a);
+
+	// Same as FenixUtils AnticipatePos, cached per actor and dtime within a frame
+	RE::NiPoint3 AnticipatePos(RE::Actor* a, float dtime = 0.0f);
+}
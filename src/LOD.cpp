@@ -0,0 +1,109 @@
+#include "LOD.h"
+#include "PerFrame.h"
+#include "Settings.h"
+#include "Stats.h"
+
+namespace LOD
+{
+	enum class Bucket : uint32_t
+	{
+		Near,
+		Mid,
+		Far
+	};
+
+	struct Viewer
+	{
+		uint32_t frame = 0;
+		RE::NiPoint3 pos;
+		RE::NiPoint3 dir;
+	};
+
+	static const Viewer& get_viewer()
+	{
+		static Viewer viewer;
+		if (auto frame = PerFrame::get_frame(); viewer.frame != frame) {
+			viewer.frame = frame;
+			auto player = RE::PlayerCharacter::GetSingleton();
+			viewer.pos = player->GetPosition();
+			viewer.dir = FenixUtils::Geom::angles2dir(player->data.angle);
+		}
+		return viewer;
+	}
+
+	// Bucket by distance, one farther if the projectile is behind the player's view
+	static Bucket get_bucket(RE::Projectile* proj)
+	{
+		const auto& settings = Settings::get();
+		const auto& viewer = get_viewer();
+
+		auto d = proj->GetPosition() - viewer.pos;
+		float dist2 = d.SqrLength();
+
+		auto bucket = static_cast<uint32_t>(Bucket::Near);
+		if (dist2 > settings.lod_mid_distance * settings.lod_mid_distance)
+			bucket++;
+		if (settings.lod_far_distance > 0.0f && dist2 > settings.lod_far_distance * settings.lod_far_distance)
+			bucket++;
+		if (d.Dot(viewer.dir) < 0.0f)
+			bucket++;
+
+		return static_cast<Bucket>(std::min(bucket, static_cast<uint32_t>(Bucket::Far)));
+	}
+
+	static uint32_t get_rate(Bucket bucket)
+	{
+		const auto& settings = Settings::get();
+		switch (bucket) {
+		case Bucket::Mid:
+			return std::max(settings.lod_mid_rate, 1u);
+		case Bucket::Far:
+			return std::max(settings.lod_far_rate, 1u);
+		case Bucket::Near:
+		default:
+			return 1;
+		}
+	}
+
+	// Projectiles of a bucket are spread over frames by formID
+	static bool is_update_frame(RE::Projectile* proj, uint32_t rate)
+	{
+		return (PerFrame::get_frame() + proj->formID) % rate == 0;
+	}
+
+	bool is_skipped(RE::Projectile* proj)
+	{
+		if (Settings::get().lod_mid_distance <= 0.0f)
+			return false;
+
+		return !is_update_frame(proj, get_rate(get_bucket(proj)));
+	}
+
+	bool update_now(RE::Projectile* proj, float& dtime)
+	{
+		if (Settings::get().lod_mid_distance <= 0.0f)
+			return true;
+
+		auto bucket = get_bucket(proj);
+		switch (bucket) {
+		case Bucket::Near:
+			Stats::inc(Stats::Counter::LODNear);
+			break;
+		case Bucket::Mid:
+			Stats::inc(Stats::Counter::LODMid);
+			break;
+		case Bucket::Far:
+			Stats::inc(Stats::Counter::LODFar);
+			break;
+		}
+
+		auto rate = get_rate(bucket);
+		if (!is_update_frame(proj, rate)) {
+			Stats::inc(Stats::Counter::LODSkipped);
+			return false;
+		}
+
+		dtime *= static_cast<float>(rate);
+		return true;
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Steering level of detail. Projectiles far from the player or behind the camera are steered less often
+namespace LOD
+{
+	// Whether steering of `proj` runs this frame. If so, `dtime` is scaled to cover the skipped frames
+	bool update_now(RE::Projectile* proj, float& dtime);
+
+	// Same decision without counters and without scaling
+	bool is_skipped(RE::Projectile* proj);
+}
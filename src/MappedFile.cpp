@@ -0,0 +1,36 @@
+#include "MappedFile.h"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	auto handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	file = handle;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0)
+		return;
+
+	mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+		return;
+
+	view = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (view)
+		len = static_cast<size_t>(file_size.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+	if (view)
+		UnmapViewOfFile(view);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+	// Empty on failure
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const std::byte* data() const { return view; }
+	size_t size() const { return len; }
+	explicit operator bool() const { return view != nullptr; }
+
+private:
+	void* file = nullptr;
+	void* mapping = nullptr;
+	const std::byte* view = nullptr;
+	size_t len = 0;
+};
@@ -3,6 +3,7 @@
 #include "Triggers.h"
 #include "Homing.h"
 #include "Positioning.h"
+#include "Kinematics.h"
 #include <random>
 
 namespace Multicast
@@ -102,32 +103,46 @@ namespace Multicast
 		static inline std::vector<SpawnGroupData> data;
 	};
 
-	struct SpellData
-	{
-		uint32_t spellID;  // -1 = Current
-	};
-
-	struct ArrowData
-	{
-		uint32_t weapID;   // -1 = Current
-		uint32_t arrowID;  // -1 = Current
-	};
-
+	// Forms to launch, resolved once at load. nullptr means Current, taken from the cast
 	struct SpellArrowData
 	{
-		std::variant<SpellData, ArrowData> data;
-
-		static uint32_t currentOrID(const std::string& filename, const Json::Value& item, const std::string& field)
+		RE::SpellItem* spel;
+		RE::TESObjectWEAP* weap;
+		RE::TESAmmo* ammo;
+		uint32_t is_arrow: 1;
+		uint32_t valid: 1;  // all forms are found, the group is skipped otherwise
+
+		SpellArrowData(const std::string& filename, const Json::Value& item) :
+			spel(nullptr), weap(nullptr), ammo(nullptr), is_arrow(!item.isMember("spellID")), valid(true)
 		{
-			auto spellID = JsonUtils::getString(item, field);
-			if (spellID == "Current")
-				return CURRENT;
-			else
-				return JsonUtils::get_formid(filename, spellID);
+			if (!is_arrow) {
+				spel = resolve<RE::SpellItem>(filename, item, "spellID");
+			} else {
+				weap = resolve<RE::TESObjectWEAP>(filename, item, "weapID");
+				if (item.isMember("arrowID"))
+					ammo = resolve<RE::TESAmmo>(filename, item, "arrowID");
+			}
 		}
 
-		static constexpr uint32_t CURRENT = static_cast<uint32_t>(-1);
+	private:
+		// nullptr for Current. Not found forms are reported here, so casts never look them up
+		template <typename T>
+		T* resolve(const std::string& filename, const Json::Value& item, const std::string& field)
+		{
+			auto id = JsonUtils::getString(item, field);
+			if (id == "Current")
+				return nullptr;
+
+			auto formid = JsonUtils::get_formid(filename, id);
+			if (auto form = RE::TESForm::LookupByID<T>(formid))
+				return form;
+
+			logger::warn("{}: {} {} ({:#x}) is not found, the spawn group is skipped"sv, filename, field, id, formid);
+			valid = false;
+			return nullptr;
+		}
 	};
+	static_assert(sizeof(SpellArrowData) == 0x20);
 
 	enum class HomingDetectionType : uint32_t
 	{
@@ -199,26 +214,8 @@ namespace Multicast
 
 		static void read_json_entry_item(const std::string& filename, std::vector<Data>& new_data, const Json::Value& item)
 		{
-			SpellArrowData origin_formIDs;
-			if (item.isMember("spellID")) {
-				origin_formIDs.data = SpellData{};
-				auto& spelldata = std::get<SpellData>(origin_formIDs.data);
-
-				spelldata.spellID = SpellArrowData::currentOrID(filename, item, "spellID");
-			} else if (item.isMember("weapID")) {
-				origin_formIDs.data = ArrowData{};
-				auto& arrowdata = std::get<ArrowData>(origin_formIDs.data);
-
-				arrowdata.weapID = SpellArrowData::currentOrID(filename, item, "weapID");
-
-				if (item.isMember("arrowID")) {
-					arrowdata.arrowID = SpellArrowData::currentOrID(filename, item, "arrowID");
-				} else {
-					arrowdata.arrowID = SpellArrowData::CURRENT;
-				}
-			} else {
-				assert(false);
-			}
+			assert(item.isMember("spellID") || item.isMember("weapID"));
+			SpellArrowData origin_formIDs(filename, item);
 
 			TriggerFunctions::Functions functions;
 			HomingDetectionType homing_detection =
@@ -416,7 +413,7 @@ namespace Multicast
 				{
 					if (target)
 						return rot_at(item_pos, target->As<RE::Actor>() ?
-													FenixUtils::Geom::Actor::AnticipatePos(target->As<RE::Actor>()) :
+													Kinematics::AnticipatePos(target->As<RE::Actor>()) :
 													target->GetPosition());
 					else
 						break;
@@ -495,42 +492,28 @@ namespace Multicast
 		// SP_CD has info about cast. Copied, because every SP has info itself.
 		void multiCastGroup(CastData SP_CD, const Data& data, RE::TESObjectREFR* origin, RE::TESObjectREFR* caster)
 		{
-			const auto& spellarrow_data = data.origin_formIDs;
-
-			auto type = spellarrow_data.data.index();
-			// SpellData
-			if (type == 0) {
-				auto& spell_data = std::get<SpellData>(spellarrow_data.data);
-				auto spell_id = spell_data.spellID;
-
-				assert(SP_CD.spellarrow_data.index() == 0 || spell_id != SpellArrowData::CURRENT);
-
-				if (SP_CD.spellarrow_data.index() != 0)
-					SP_CD.spellarrow_data = CastData::SpellData{};
-
-				if (spell_id != SpellArrowData::CURRENT)
-					std::get<CastData::SpellData>(SP_CD.spellarrow_data).spel = RE::TESForm::LookupByID<RE::SpellItem>(spell_id);
-			}
-			// ArrowData
-			if (type == 1) {
-				auto& arrow_data = std::get<ArrowData>(spellarrow_data.data);
-
-				auto arrow_id = arrow_data.arrowID;
-				auto weap_id = arrow_data.weapID;
-
-				assert(SP_CD.spellarrow_data.index() == 1 ||
-					   (weap_id != SpellArrowData::CURRENT && arrow_id != SpellArrowData::CURRENT));
-
-				if (SP_CD.spellarrow_data.index() != 1)
+			const auto& forms = data.origin_formIDs;
+			if (!forms.valid)
+				return;
+
+			if (!forms.is_arrow) {
+				if (forms.spel) {
+					SP_CD.spellarrow_data = CastData::SpellData{ forms.spel };
+				} else if (SP_CD.spellarrow_data.index() != 0) {
+					assert(false);  // Current of another type
+					return;
+				}
+			} else {
+				if (SP_CD.spellarrow_data.index() != 1) {
+					assert(forms.weap && forms.ammo);
 					SP_CD.spellarrow_data = CastData::ArrowData{};
+				}
 
 				auto& arrowdata = std::get<CastData::ArrowData>(SP_CD.spellarrow_data);
-				if (weap_id != SpellArrowData::CURRENT) {
-					arrowdata.weap = RE::TESForm::LookupByID<RE::TESObjectWEAP>(weap_id);
-				}
-				if (arrow_id != SpellArrowData::CURRENT) {
-					arrowdata.ammo = RE::TESForm::LookupByID<RE::TESAmmo>(arrow_id);
-				}
+				if (forms.weap)
+					arrowdata.weap = forms.weap;
+				if (forms.ammo)
+					arrowdata.ammo = forms.ammo;
 			}
 
 			auto& pattern_data = SpawnGroupStorage::get_data(data.pattern_ind);
@@ -558,12 +541,14 @@ namespace Multicast
 			}
 
 			bool needsound_every = pattern_data.sound == SoundType::Every;
-			bool needsound_single = type == 0 && pattern_data.sound == SoundType::Single;
+			bool needsound_single = SP_CD.spellarrow_data.index() == 0 && pattern_data.sound == SoundType::Single;
 			size_t target_ind = 0;
 
-			Positioning::Plane plane(SP_CD.start_pos, cast_dir);
-			for (size_t i = 0; i < pattern_data.pattern.getSize(); i++) {
-				auto point = pattern_data.pattern.GetPosition(plane, cast_dir, i);
+			// Projectiles are launched once, the animation of the pattern is for followers' formations only
+			Positioning::Positions points;
+			pattern_data.pattern.GetPositions({ SP_CD.start_pos, cast_dir }, points);
+			for (size_t i = 0; i < points.size(); i++) {
+				auto point = points[i];
 
 				RE::Actor* target = nullptr;
 
@@ -0,0 +1,68 @@
+#include "NodeRotation.h"
+#include "PerFrame.h"
+#include "Stats.h"
+
+namespace NodeRotation
+{
+	constexpr float COS_THRESHOLD = 0.9999f;  // ~0.8 deg
+	constexpr uint32_t PRUNE_FRAMES = 300;
+
+	struct Entry
+	{
+		RE::Projectile* proj;  // formIDs of projectiles are reused, only compared
+		RE::NiPoint3 dir;      // last applied, unit
+		uint32_t frame;
+	};
+
+	static std::unordered_map<RE::FormID, Entry> applied;
+	static uint32_t last_prune = 0;
+
+	static void prune(uint32_t frame)
+	{
+		if (frame - last_prune < PRUNE_FRAMES)
+			return;
+
+		last_prune = frame;
+		std::erase_if(applied, [frame](const auto& item) { return frame - item.second.frame >= PRUNE_FRAMES; });
+	}
+
+	// `goal` is unit or zero, zero if any small change may be skipped
+	static void update_impl(RE::Projectile* proj, const RE::NiPoint3& dir, const RE::NiPoint3& goal)
+	{
+		auto frame = PerFrame::get_frame();
+		prune(frame);
+
+		auto unit = dir;
+		if (unit.Unitize() == 0.0f) {
+			FenixUtils::Geom::Projectile::update_node_rotation(proj, dir);
+			return;
+		}
+
+		auto [found, inserted] = applied.try_emplace(proj->formID, Entry{ proj, unit, frame });
+		auto& entry = found->second;
+		bool reached = goal.SqrLength() == 0.0f || entry.dir.Dot(goal) > COS_THRESHOLD;
+		if (!inserted && entry.proj == proj && reached && entry.dir.Dot(unit) > COS_THRESHOLD) {
+			entry.frame = frame;
+			Stats::inc(Stats::Counter::NodeRotationSkipped);
+			return;
+		}
+
+		entry = { proj, unit, frame };
+		Stats::inc(Stats::Counter::NodeRotationUpdated);
+		FenixUtils::Geom::Projectile::update_node_rotation(proj, dir);
+	}
+
+	void update(RE::Projectile* proj, const RE::NiPoint3& dir) { update_impl(proj, dir, RE::NiPoint3()); }
+
+	void update(RE::Projectile* proj, const RE::NiPoint3& dir, const RE::NiPoint3& goal)
+	{
+		auto unit_goal = goal;
+		if (unit_goal.Unitize() == 0.0f) {
+			FenixUtils::Geom::Projectile::update_node_rotation(proj, dir);
+			return;
+		}
+		update_impl(proj, dir, unit_goal);
+	}
+
+	void update(RE::Projectile* proj) { update(proj, proj->linearVelocity); }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Node rotation of projectiles, skipped while the direction barely changes
+namespace NodeRotation
+{
+	// Same as FenixUtils update_node_rotation
+	void update(RE::Projectile* proj, const RE::NiPoint3& dir);
+
+	// For `dir` stepped from the current angle of `proj` towards `goal`: skipped only once `goal` is reached,
+	// a skipped step is never written to the angle, so small steps would never add up
+	void update(RE::Projectile* proj, const RE::NiPoint3& dir, const RE::NiPoint3& goal);
+
+	// Along the velocity
+	void update(RE::Projectile* proj);
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Moving followers along their orbits, one at a time or 4 at once. Has no game dependencies:
+// `Vec` is any type with float x, y, z and a constructor from them, like RE::NiPoint3
+namespace OrbitSolver
+{
+	// A follower is on its orbit if its distance to the center is within these factors of the radius
+	constexpr float CIRCLE_K = 0.01f;
+	constexpr float CIRCLE_K_BIG = 1.0f + CIRCLE_K;
+	constexpr float CIRCLE_K_SML = 1.0f - CIRCLE_K;
+
+	namespace Scalar
+	{
+		template <typename Vec>
+		float dot(const Vec& a, const Vec& b)
+		{
+			return a.x * b.x + a.y * b.y + a.z * b.z;
+		}
+
+		template <typename Vec>
+		Vec cross(const Vec& a, const Vec& b)
+		{
+			return Vec(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+		}
+
+		template <typename Vec>
+		Vec UnitCross(const Vec& a, const Vec& b)
+		{
+			auto c = cross(a, b);
+			float len = std::sqrt(dot(c, c));
+			return len > 0 ? Vec(c.x / len, c.y / len, c.z / len) : Vec(0, 0, 0);
+		}
+
+		// Same as Geom::rotate: `P` around the line through `O` along unit `axis`
+		template <typename Vec>
+		Vec rotate(const Vec& P, float alpha, const Vec& O, const Vec& axis)
+		{
+			float c = std::cos(alpha);
+			float s = std::sin(alpha);
+			Vec v(P.x - O.x, P.y - O.y, P.z - O.z);
+			auto w = cross(axis, v);
+			float k = dot(axis, v) * (1 - c);
+			return Vec(O.x + v.x * c + w.x * s + axis.x * k, O.y + v.y * c + w.y * s + axis.y * k,
+				O.z + v.z * c + w.z * s + axis.z * k);
+		}
+	}
+
+	// Follower at `P` is on the sphere of radius `R` around `O`, or on the cylinder around the unit axis `C`
+	template <typename Vec>
+	bool on_orbit(const Vec& P, const Vec& O, const Vec& C, float R, bool sphere)
+	{
+		Vec rel(P.x - O.x, P.y - O.y, P.z - O.z);
+		float D2 = Scalar::dot(rel, rel);
+		if (!sphere) {
+			float dir_z = Scalar::dot(C, rel);
+			D2 -= dir_z * dir_z;
+		}
+		float R2 = R * R;
+		return R > 0 && D2 <= R2 * CIRCLE_K_BIG * CIRCLE_K_BIG && D2 >= R2 * CIRCLE_K_SML * CIRCLE_K_SML;
+	}
+
+	// "On circle" case of the Sphere rounding: rotates `P` around `O` in the plane of the velocity `V`
+	template <typename Vec>
+	Vec step_sphere(const Vec& P, const Vec& V, const Vec& O, float R, float dtime)
+	{
+		using namespace Scalar;
+		Vec rel(P.x - O.x, P.y - O.y, P.z - O.z);
+		auto axis = UnitCross(V, Vec(-rel.x, -rel.y, -rel.z));
+		float phi = dtime * std::sqrt(dot(V, V)) / R;
+		if (dot(UnitCross(rel, axis), V) >= 0)
+			phi *= -1;
+		return rotate(P, phi, O, axis);
+	}
+
+	// "On cylinder" case of the Plane rounding: moves `P` around the axis `C` through `O` and towards the plane of `O`
+	template <typename Vec>
+	Vec step_plane(const Vec& P, const Vec& V, const Vec& O, const Vec& C, float R, float dtime)
+	{
+		using namespace Scalar;
+		Vec rel(P.x - O.x, P.y - O.y, P.z - O.z);
+		float dir_z = -dot(C, rel);
+		float L = dtime * std::sqrt(dot(V, V));
+		float H = std::abs(dir_z);
+		float t = L > H + 0.0001f ? std::min(1.0f, H / std::sqrt(L * L - H * H)) : 1.0f;
+
+		float dl = L / std::sqrt(1 + t * t);
+		float dh = dl * t;
+		float df = dl / R;
+		// Cross of projections to the plane of `C` is -dot(rel x V, C)
+		if (dot(cross(rel, V), C) <= 0)
+			df *= -1;
+		auto ans = rotate(P, df, O, C);
+		if (dir_z < 0)
+			dh *= -1;
+		return Vec(ans.x + C.x * dh, ans.y + C.y * dh, ans.z + C.z * dh);
+	}
+
+	// Followers on their orbits, solved 4 at once. Spheres and planes are kept apart,
+	// so every block of lanes is dense and runs one kind of math
+	class Batch
+	{
+	public:
+		static constexpr uint32_t SPHERE = 1u << 31;  // lane flag
+
+		void clear()
+		{
+			spheres.clear();
+			planes.clear();
+		}
+
+		size_t size() const { return spheres.count + planes.count; }
+
+		// Returns the lane of the follower, `C` is ignored for spheres. Followers must be `on_orbit`
+		template <typename Vec>
+		uint32_t add(const Vec& P, const Vec& V, const Vec& O, const Vec& C, float R, bool sphere)
+		{
+			auto& lanes = sphere ? spheres : planes;
+			auto ind = static_cast<uint32_t>(lanes.count++);
+			if (ind % SIMD::WIDTH == 0)
+				lanes.blocks.emplace_back();  // zero radius, padding lanes are never valid
+
+			auto& block = lanes.blocks.back();
+			auto j = ind % SIMD::WIDTH;
+			block.px[j] = P.x;
+			block.py[j] = P.y;
+			block.pz[j] = P.z;
+			block.vx[j] = V.x;
+			block.vy[j] = V.y;
+			block.vz[j] = V.z;
+			block.ox[j] = O.x;
+			block.oy[j] = O.y;
+			block.oz[j] = O.z;
+			block.cx[j] = C.x;
+			block.cy[j] = C.y;
+			block.cz[j] = C.z;
+			block.radius[j] = R;
+			return sphere ? ind | SPHERE : ind;
+		}
+
+		void solve(float dtime)
+		{
+			solve_sphere(spheres, dtime);
+			solve_plane(planes, dtime);
+		}
+
+		// Result of the lane, false if the follower cannot move along the orbit (no speed, no plane of motion)
+		template <typename Vec>
+		bool get(uint32_t lane, Vec& ans) const
+		{
+			const auto& lanes = (lane & SPHERE) ? spheres : planes;
+			auto i = lane & ~SPHERE;
+			const auto& block = lanes.blocks[i / SIMD::WIDTH];
+			auto j = i % SIMD::WIDTH;
+			if (!((block.ok >> j) & 1))
+				return false;
+
+			ans = Vec(block.rx[j], block.ry[j], block.rz[j]);
+			return true;
+		}
+
+	private:
+		// 4 lanes as a structure of arrays, so adding a follower touches one cache line region
+		struct alignas(16) Block
+		{
+			float px[SIMD::WIDTH], py[SIMD::WIDTH], pz[SIMD::WIDTH];  // follower position
+			float vx[SIMD::WIDTH], vy[SIMD::WIDTH], vz[SIMD::WIDTH];  // follower velocity
+			float ox[SIMD::WIDTH], oy[SIMD::WIDTH], oz[SIMD::WIDTH];  // orbit center
+			float cx[SIMD::WIDTH], cy[SIMD::WIDTH], cz[SIMD::WIDTH];  // cast_dir, Plane only
+			float radius[SIMD::WIDTH];
+			float rx[SIMD::WIDTH], ry[SIMD::WIDTH], rz[SIMD::WIDTH];  // result point
+			int ok;                                                   // result is valid, bit per lane
+		};
+
+		struct Lanes
+		{
+			std::vector<Block> blocks;
+			size_t count = 0;
+
+			void clear()
+			{
+				blocks.clear();
+				count = 0;
+			}
+		};
+
+		// Same as step_sphere
+		static void solve_sphere(Lanes& lanes, float dtime)
+		{
+			using namespace SIMD;
+
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 sign = _mm_set1_ps(-0.0f);
+
+			for (auto& block : lanes.blocks) {
+				auto P = load(block.px, block.py, block.pz);
+				auto V = load(block.vx, block.vy, block.vz);
+				auto O = load(block.ox, block.oy, block.oz);
+				__m128 R = _mm_load_ps(block.radius);
+
+				auto rel = sub(P, O);
+				auto axis = UnitCross(V, sub(O, P));
+				__m128 L = _mm_mul_ps(_mm_sqrt_ps(dot(V, V)), _mm_set1_ps(dtime));
+				__m128 phi = _mm_div_ps(L, R);
+				__m128 forward = _mm_cmpge_ps(dot(UnitCross(rel, axis), V), zero);
+				phi = select(forward, _mm_xor_ps(phi, sign), phi);
+
+				__m128 cos_a, sin_a;
+				sincos(phi, sin_a, cos_a);
+				store(rotate(P, cos_a, sin_a, O, axis), block.rx, block.ry, block.rz);
+
+				__m128 valid = _mm_and_ps(_mm_cmpgt_ps(R, zero), _mm_cmpgt_ps(L, zero));
+				block.ok = _mm_movemask_ps(_mm_and_ps(valid, _mm_cmpgt_ps(dot(axis, axis), zero)));
+			}
+		}
+
+		// Same as step_plane
+		static void solve_plane(Lanes& lanes, float dtime)
+		{
+			using namespace SIMD;
+
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 sign = _mm_set1_ps(-0.0f);
+			const __m128 eps = _mm_set1_ps(0.0001f);
+
+			for (auto& block : lanes.blocks) {
+				auto P = load(block.px, block.py, block.pz);
+				auto V = load(block.vx, block.vy, block.vz);
+				auto O = load(block.ox, block.oy, block.oz);
+				auto C = load(block.cx, block.cy, block.cz);
+				__m128 R = _mm_load_ps(block.radius);
+
+				auto rel = sub(P, O);
+				__m128 dir_z = _mm_xor_ps(dot(C, rel), sign);
+				__m128 L = _mm_mul_ps(_mm_sqrt_ps(dot(V, V)), _mm_set1_ps(dtime));
+				__m128 H = _mm_andnot_ps(sign, dir_z);
+				__m128 L2H2 = _mm_max_ps(_mm_sub_ps(_mm_mul_ps(L, L), _mm_mul_ps(H, H)), eps);
+				__m128 t = _mm_min_ps(one, _mm_div_ps(H, _mm_sqrt_ps(L2H2)));
+				t = select(_mm_cmpgt_ps(L, _mm_add_ps(H, eps)), t, one);
+
+				__m128 dl = _mm_div_ps(L, _mm_sqrt_ps(_mm_add_ps(one, _mm_mul_ps(t, t))));
+				__m128 dh = _mm_mul_ps(dl, t);
+				dh = select(_mm_cmplt_ps(dir_z, zero), _mm_xor_ps(dh, sign), dh);
+				__m128 df = _mm_div_ps(dl, R);
+				__m128 ccw = _mm_cmple_ps(dot(cross(rel, V), C), zero);
+				df = select(ccw, _mm_xor_ps(df, sign), df);
+
+				__m128 cos_a, sin_a;
+				sincos(df, sin_a, cos_a);
+				auto ans = SIMD::add(rotate(P, cos_a, sin_a, O, C), mul(C, dh));  // Batch::add hides it
+				store(ans, block.rx, block.ry, block.rz);
+
+				__m128 valid = _mm_and_ps(_mm_cmpgt_ps(R, zero), _mm_cmpgt_ps(L, zero));
+				block.ok = _mm_movemask_ps(_mm_and_ps(valid, _mm_cmpgt_ps(dot(C, C), zero)));
+			}
+		}
+
+		Lanes spheres, planes;
+	};
+}
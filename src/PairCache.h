@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+// Values of ordered pairs of ids (formIDs), each reused for `ttl` seconds. Has no game dependencies
+template <typename T>
+class PairCache
+{
+public:
+	PairCache(float ttl, float prune_interval) : ttl(ttl), prune_interval(prune_interval) {}
+
+	// Cached value of (a, b) or `compute()` if it is missing or too old. `hit` tells which one
+	template <typename F>
+	T get(uint32_t a, uint32_t b, float now, F&& compute, bool& hit)
+	{
+		prune(now);
+
+		auto [found, inserted] = cache.try_emplace(get_key(a, b));
+		auto& entry = found->second;
+		hit = !inserted && now - entry.time <= ttl;
+		if (!hit) {
+			entry.time = now;
+			entry.value = compute();
+		}
+		return entry.value;
+	}
+
+	// Both orders of the pair are dropped
+	void invalidate(uint32_t a, uint32_t b)
+	{
+		cache.erase(get_key(a, b));
+		cache.erase(get_key(b, a));
+	}
+
+	void clear()
+	{
+		cache.clear();
+		last_prune = 0.0f;
+	}
+
+	size_t size() const { return cache.size(); }
+
+private:
+	struct Entry
+	{
+		float time = 0.0f;
+		T value{};
+	};
+
+	static uint64_t get_key(uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; }
+
+	// Keeps the map small, only outdated entries are dropped
+	void prune(float now)
+	{
+		if (now - last_prune < prune_interval)
+			return;
+
+		last_prune = now;
+		std::erase_if(cache, [this, now](const auto& item) { return now - item.second.time > ttl; });
+	}
+
+	std::unordered_map<uint64_t, Entry> cache;
+	float ttl;
+	float prune_interval;
+	float last_prune = 0.0f;
+};
@@ -0,0 +1,48 @@
+#include "PerFrame.h"
+#include "Stats.h"
+#include "TargetScanner.h"
+
+namespace PerFrame
+{
+	static uint32_t cur_frame = 1;
+	static double cur_time = 0.0;
+
+	uint32_t get_frame() { return cur_frame; }
+	float get_time() { return static_cast<float>(cur_time); }
+	double get_precise_time() { return cur_time; }
+
+	namespace Hooks
+	{
+		// Frame counter, used to invalidate per-frame caches
+		class FrameHook
+		{
+		public:
+			static void Hook()
+			{
+				_Update = REL::Relocation<uintptr_t>(REL::ID(RE::VTABLE_PlayerCharacter[0])).write_vfunc(0xad, Update);
+			}
+
+		private:
+			static void Update(RE::PlayerCharacter* a, float delta)
+			{
+				_Update(a, delta);
+
+				cur_frame++;
+				if (cur_frame == 0)
+					cur_frame = 1;
+				cur_time += delta;
+
+				TargetScanner::on_frame();
+				Stats::on_frame(get_time());
+			}
+
+			static inline REL::Relocation<decltype(Update)> _Update;
+		};
+	}
+
+	void install()
+	{
+		Hooks::FrameHook::Hook();
+		TargetScanner::install();
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace PerFrame
+{
+	// Id of current frame. Incremented on every player update, never 0
+	uint32_t get_frame();
+
+	// Game time since the plugin is loaded, in seconds
+	float get_time();
+
+	// Same in double, for phases of periodic motion: a float sum of frame times jitters after hours
+	double get_precise_time();
+
+	void install();
+}
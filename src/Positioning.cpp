@@ -1,7 +1,55 @@
 #include "Positioning.h"
+#include "PerFrame.h"
+#include "Stats.h"
+#include "MappedFile.h"
+#include "BonesCache.h"
 
 namespace Positioning
 {
+	struct BonesTraits
+	{
+		using Node = RE::NiAVObject;
+		using NodePtr = RE::NiPointer<RE::NiAVObject>;
+		using Refr = RE::TESObjectREFR;
+		using Handle = RE::ObjectRefHandle;
+		using Name = RE::BSFixedString;
+
+		struct NameHash
+		{
+			size_t operator()(const Name& name) const { return std::hash<const char*>()(name.data()); }
+		};
+
+		static Handle get_handle(Refr* refr) { return refr->GetHandle(); }
+		static Refr* get_refr(const Handle& handle) { return handle.get().get(); }
+		static Node* find(Node* root, const Name& name) { return root->GetObjectByName(name); }
+	};
+
+	// Resolved origin nodes
+	static BonesCache<BonesTraits> bones;
+
+	static RE::NiAVObject* get_bone(RE::TESObjectREFR* refr, const RE::BSFixedString& name)
+	{
+		bool first_person = refr->IsPlayerRef() && !refr->Is3rdPersonVisible();
+		auto root = refr->Get3D1(first_person);
+		if (!root)
+			return nullptr;
+
+		bool hit;
+		auto ans = bones.get(refr, first_person, root, name, PerFrame::get_time(), hit);
+		Stats::inc(hit ? Stats::Counter::BoneCacheHit : Stats::Counter::BoneCacheMiss);
+		return ans;
+	}
+
+	void Pattern::initCenter(RE::NiPoint3& center, const RE::Projectile::ProjectileRot& rot, RE::TESObjectREFR* origin_refr) const
+	{
+		if (!origin.empty()) {
+			if (auto bone = get_bone(origin_refr, origin)) {
+				center = bone->world.translate;
+			}
+		}
+		center += rotateDependsX(pos_offset, rot);
+	}
+
 	RE::NiPoint3 Pattern::GetPosition_Single(const Plane& plane, size_t) const { return plane.startPos; }
 	RE::NiPoint3 Pattern::GetPosition_Line(const Plane& plane, size_t ind) const
 	{
@@ -134,4 +182,376 @@ namespace Positioning
 
 		return plane.startPos + (plane.right_dir * x + plane.up_dir * z + forward_dir * y) * c;
 	}
+
+	// Point cloud file of the Custom shape, used as a table as is:
+	// header, then x, y and z of all points, each array is padded to the SIMD width
+	constexpr uint32_t MAX_COUNT = (1 << 27) - 1;  // Pattern::count
+
+	namespace PointCloud
+	{
+		struct Header
+		{
+			char magic[4];  // NPPC
+			uint32_t version;
+			uint32_t count;
+			uint32_t reserved;
+		};
+		static_assert(sizeof(Header) == 0x10);
+
+		constexpr uint32_t VERSION = 1;
+
+		static size_t get_padded(size_t count) { return (count + SIMD::WIDTH - 1) / SIMD::WIDTH * SIMD::WIDTH; }
+
+		// Points of a valid file, nullptr otherwise
+		static const float* get_points(const MappedFile& file, uint32_t& count)
+		{
+			if (!file || file.size() < sizeof(Header))
+				return nullptr;
+
+			auto header = reinterpret_cast<const Header*>(file.data());
+			if (std::memcmp(header->magic, "NPPC", 4) || header->version != VERSION || header->count == 0 ||
+				header->count > MAX_COUNT || file.size() != sizeof(Header) + get_padded(header->count) * 3 * sizeof(float))
+				return nullptr;
+
+			count = header->count;
+			return reinterpret_cast<const float*>(file.data() + sizeof(Header));
+		}
+	}
+
+	// Local positions of figures. Patterns only keep indices, so the tables live until the next json reading
+	class Tables
+	{
+	public:
+		// Points are padded to the SIMD width
+		struct Table
+		{
+			const float* x;
+			const float* y;
+			const float* z;
+			uint32_t count;
+			bool baked;  // rotate_alpha and size are applied, otherwise they are applied per cast
+		};
+
+		// Pattern::table_ind is 16 bits
+		static constexpr size_t MAX_TABLES = 0x10000;
+
+		// Table of the point at the start, always present. Patterns without a table of their own fall back to it
+		static constexpr uint32_t SINGLE = 0;
+
+		// Returns the index of a table with `local` for the figure, makes it with `bake()` if there is none.
+		// nullopt if there are too many tables
+		template <typename F>
+		static std::optional<uint32_t> get(Shape shape, uint32_t count, float size, float rotate_alpha, F&& bake)
+		{
+			Key key{ shape, count, size, rotate_alpha };
+			if (auto found = keys.find(key); found != keys.end())
+				return found->second;
+
+			if (is_full())
+				return std::nullopt;
+
+			auto& local = baked.emplace_back(bake());
+			auto ind = add({ local.x.data(), local.y.data(), local.z.data(), count, true });
+			keys.insert({ key, ind });
+			return ind;
+		}
+
+		// Returns the index of a table of the mapped points file, nullopt if the file is invalid or there are too many tables
+		static std::optional<uint32_t> map(const std::string& filename)
+		{
+			if (auto found = files.find(filename); found != files.end())
+				return found->second;
+
+			if (is_full())
+				return std::nullopt;
+
+			auto path = std::filesystem::path("Data/HomingProjectiles") / filename;
+			auto& file = mapped.emplace_back(std::make_unique<MappedFile>(path));
+			uint32_t count = 0;
+			auto points = PointCloud::get_points(*file, count);
+			if (!points) {
+				mapped.pop_back();
+				return std::nullopt;
+			}
+
+			auto padded = PointCloud::get_padded(count);
+			auto ind = add({ points, points + padded, points + 2 * padded, count, false });
+			files.insert({ filename, ind });
+			return ind;
+		}
+
+		// Returns the index of a table with every point of `child` placed at every point of `parent`,
+		// nullopt if there are too many tables
+		static std::optional<uint32_t> compose(const Positions& parent, const Positions& child)
+		{
+			if (is_full())
+				return std::nullopt;
+
+			auto& local = baked.emplace_back();
+			Figures::compose(parent, child, local);
+			return add({ local.x.data(), local.y.data(), local.z.data(), static_cast<uint32_t>(local.size()), true });
+		}
+
+		static const Table& get(uint32_t ind) { return tables[ind]; }
+
+		static void clear()
+		{
+			tables.resize(SINGLE + 1);
+			keys.clear();
+			baked.clear();
+			files.clear();
+			mapped.clear();
+		}
+
+		static void log()
+		{
+			size_t points = 0;
+			size_t bytes = 0;
+			for (const auto& table : baked) {
+				points += table.size();
+				bytes += sizeof(Positions) + (table.x.capacity() + table.y.capacity() + table.z.capacity()) * sizeof(float);
+			}
+			size_t mapped_bytes = 0;
+			for (const auto& file : mapped) {
+				mapped_bytes += file->size();
+			}
+			logger::info("Pattern tables: {} baked ({} points, {} bytes), {} mapped files ({} bytes)"sv, baked.size(), points,
+				bytes, mapped.size(), mapped_bytes);
+		}
+
+	private:
+		struct Key
+		{
+			Shape shape;
+			uint32_t count;
+			float size;
+			float rotate_alpha;
+
+			bool operator==(const Key&) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const
+			{
+				return std::hash<float>()(key.size) ^ std::hash<float>()(key.rotate_alpha) << 1 ^
+				       (static_cast<size_t>(key.count) << 4 | static_cast<size_t>(key.shape));
+			}
+		};
+
+		static bool is_full()
+		{
+			if (tables.size() < MAX_TABLES)
+				return false;
+
+			logger::error("Too many pattern tables (max {})"sv, MAX_TABLES);
+			return true;
+		}
+
+		static uint32_t add(const Table& table)
+		{
+			tables.push_back(table);
+			return static_cast<uint32_t>(tables.size() - 1);
+		}
+
+		alignas(16) static constexpr float zeros[SIMD::WIDTH]{};
+		static inline std::vector<Table> tables{ { zeros, zeros, zeros, 1, true } };
+		static inline std::unordered_map<Key, uint32_t, KeyHash> keys;
+		static inline std::deque<Positions> baked;  // stable addresses
+		static inline std::unordered_map<std::string, uint32_t> files;
+		static inline std::vector<std::unique_ptr<MappedFile>> mapped;
+	};
+
+	std::optional<uint32_t> Pattern::bake() const
+	{
+		return Tables::get(shape, count, size, rotate_alpha, [this]() {
+			Positions ans;
+			ans.resize(count);
+			Figures::get_local(shape, count, size, ans);
+			Figures::rotate_local(ans, rotate_alpha);
+			return ans;
+		});
+	}
+
+	Positions Pattern::getBakedLocal() const
+	{
+		const auto& table = Tables::get(table_ind);
+		Positions ans;
+		ans.resize(count);
+		float k = table.baked ? 1.0f : size;
+		for (size_t i = 0; i < ans.size(); i++) {
+			ans.x[i] = table.x[i] * k;
+			ans.y[i] = table.y[i] * k;
+			ans.z[i] = table.z[i] * k;
+		}
+		if (!table.baked)
+			Figures::rotate_local(ans, rotate_alpha);
+		return ans;
+	}
+
+	void Pattern::initChild(const Json::Value& item)
+	{
+		Pattern child(item, false);
+		if (static_cast<uint64_t>(count) * child.count > MAX_COUNT) {
+			logger::error("Composite pattern has too many points ({} x {}), Child is ignored"sv, count, child.count);
+			return;
+		}
+
+		auto ind = Tables::compose(getBakedLocal(), child.getBakedLocal());
+		if (!ind) {
+			logger::error("Composite pattern has no table, Child is ignored"sv);
+			return;
+		}
+
+		table_ind = *ind;
+		count = count * child.count;
+		shape = Shape::Composite;
+		rotate_alpha = 0.0f;  // already in the table
+	}
+
+	RE::NiPoint3 Pattern::GetPosition_Composite(const Plane& plane, size_t ind) const
+	{
+		const auto& table = Tables::get(table_ind);
+		if (ind >= table.count)
+			return plane.startPos;
+
+		auto forward_dir = plane.up_dir.UnitCross(plane.right_dir);
+
+		return plane.startPos + plane.right_dir * table.x[ind] + plane.up_dir * table.y[ind] + forward_dir * table.z[ind];
+	}
+
+	void Pattern::initTable(const Json::Value& figure)
+	{
+		if (shape == Shape::Custom) {
+			initCustom(figure);
+		} else if (auto ind = bake()) {
+			table_ind = *ind;
+		} else {
+			logger::error("Pattern has no table, Single shape is used"sv);
+			setSingle();
+		}
+	}
+
+	void Pattern::initCustom(const Json::Value& figure)
+	{
+		auto filename = JsonUtils::mb_getString(figure, "file");
+		if (auto ind = Tables::map(filename)) {
+			table_ind = *ind;
+			count = Tables::get(table_ind).count;
+			return;
+		}
+
+		logger::error("Cannot read points file \"{}\", Single shape is used"sv, filename);
+		setSingle();
+	}
+
+	void Pattern::setSingle()
+	{
+		shape = Shape::Single;
+		count = 1;
+		size = 0;
+		table_ind = Tables::SINGLE;
+	}
+
+	RE::NiPoint3 Pattern::GetPosition_Custom(const Plane& plane, size_t ind) const
+	{
+		const auto& table = Tables::get(table_ind);
+		if (ind >= table.count)
+			return plane.startPos;
+
+		auto forward_dir = plane.up_dir.UnitCross(plane.right_dir);
+
+		auto P = plane.right_dir * table.x[ind] + plane.up_dir * table.y[ind] + forward_dir * table.z[ind];
+		return plane.startPos + P * size;
+	}
+
+	static std::vector<Animation> animations;  // anim_ind - 1
+	constexpr size_t MAX_ANIMATIONS = 0xFFFF;  // Pattern::anim_ind
+
+	uint32_t Pattern::read_animation(const Json::Value& item)
+	{
+		constexpr float DEG = 3.14159265358f / 180.0f;
+		Animation anim{ JsonUtils::mb_getFloat(item, "angularVelocity") * DEG, JsonUtils::mb_getFloat(item, "pulseAmplitude"),
+			JsonUtils::mb_getFloat(item, "pulseFrequency"), JsonUtils::mb_getFloat(item, "slotPhase") * DEG };
+		if (anim.angular_velocity == 0.0f && (anim.pulse_amplitude == 0.0f || anim.pulse_frequency == 0.0f))
+			return 0;
+
+		if (animations.size() >= MAX_ANIMATIONS) {
+			logger::error("Too many animated patterns (max {}), the pattern is static"sv, MAX_ANIMATIONS);
+			return 0;
+		}
+
+		animations.push_back(anim);
+		return static_cast<uint32_t>(animations.size());
+	}
+
+	void Pattern::GetPositions(const Plane& plane, Positions& out, double time) const
+	{
+		GetPositions(plane, out, anim_ind ? &animations[anim_ind - 1] : nullptr, time);
+	}
+
+	void Pattern::GetPositions(const Plane& plane, Positions& out, const Animation* anim, double time) const
+	{
+		const auto& local = Tables::get(table_ind);
+		out.resize(count);
+
+		auto right = plane.right_dir;
+		auto up = plane.up_dir;
+		auto forward = plane.up_dir.UnitCross(plane.right_dir);
+
+		// Rotation around the start is linear, so rotate the basis instead of every point.
+		// Phases are wrapped in double, they stay exact for a long `time`
+		float alpha = local.baked ? 0.0f : rotate_alpha;
+		if (anim)
+			alpha += static_cast<float>(std::fmod(anim->angular_velocity * time, 2 * 3.141592653589793));
+		if (alpha != 0.0f) {
+			const RE::NiPoint3 zero;
+			right = FenixUtils::Geom::rotate(right, alpha, zero, forward);
+			up = FenixUtils::Geom::rotate(up, alpha, zero, forward);
+		}
+		if (!local.baked) {
+			right *= size;
+			up *= size;
+			forward *= size;
+		}
+
+		using namespace SIMD;
+		auto start = broadcast(plane.startPos);
+		auto R = broadcast(right);
+		auto U = broadcast(up);
+		auto F = broadcast(forward);
+
+		// Pulse of the slot `i` is sin(pulse + slot_phase * i), the angle is rotated incrementally
+		bool pulsing = anim && anim->pulse_amplitude != 0.0f;
+		double pulse = pulsing ? std::fmod(2 * 3.141592653589793 * anim->pulse_frequency * time, 2 * 3.141592653589793) : 0.0;
+		double c = cos(pulse);
+		double s = sin(pulse);
+		const double step_c = pulsing ? cos(anim->slot_phase) : 1.0;
+		const double step_s = pulsing ? sin(anim->slot_phase) : 0.0;
+
+		for (size_t i = 0; i < out.x.size(); i += WIDTH) {
+			auto L = load(&local.x[i], &local.y[i], &local.z[i]);
+			auto offset = add(add(mul(R, L.x), mul(U, L.y)), mul(F, L.z));
+			if (pulsing) {
+				alignas(16) float k[WIDTH];
+				for (size_t j = 0; j < WIDTH; j++) {
+					k[j] = 1.0f + anim->pulse_amplitude * static_cast<float>(s);
+					double t = c * step_c - s * step_s;
+					s = s * step_c + c * step_s;
+					c = t;
+				}
+				offset = mul(offset, _mm_load_ps(k));
+			}
+			store(add(start, offset), &out.x[i], &out.y[i], &out.z[i]);
+		}
+	}
+
+	void clear()
+	{
+		Tables::clear();
+		animations.clear();
+		bones.clear();
+	}
+
+	void log_tables() { Tables::log(); }
 }
@@ -1,24 +1,12 @@
 #pragma once
 
+#include "Figures.h"
 #include "JsonUtils.h"
+#include "SIMD.h"
 
 namespace Positioning
 {
-	enum class Shape : uint32_t
-	{
-		Single,
-		Line,
-		Circle,
-		HalfCircle,
-		FillSquare,
-		FillCircle,
-		FillHalfCircle,
-		Sphere,
-		HalfSphere,
-		Cylinder,
-
-		Total
-	};
+	using Figures::Shape;
 
 	struct Plane
 	{
@@ -37,18 +25,24 @@ namespace Positioning
 		RE::NiPoint3 unproject(const RE::NiPoint2& P) const { return right_dir * P.x + up_dir * P.y + startPos; }
 	};
 
+	// Points of a whole pattern, structure of arrays padded to the SIMD width
+	struct Positions : Figures::Points
+	{
+		RE::NiPoint3 operator[](size_t i) const { return { x[i], y[i], z[i] }; }
+	};
+
+	// Time parameters of a pattern, evaluated in closed form from the game time
+	struct Animation
+	{
+		float angular_velocity;  // radians per second about the normal
+		float pulse_amplitude;   // relative change of the distance to the center
+		float pulse_frequency;   // pulses per second
+		float slot_phase;        // pulse phase shift of every next slot, radians
+	};
+
 	struct Pattern
 	{
-		explicit Pattern(const Json::Value& item) :
-			origin(JsonUtils::mb_getString(item, "origin")),
-			normal(JsonUtils::mb_getPoint3<RE::NiPoint3(0, 1, 0)>(item, "normal")),
-			rotate_alpha(JsonUtils::mb_getFloat(item, "planeRotate") * 3.14159265358f / 180.0f),
-			pos_offset(JsonUtils::mb_getPoint3(item, "posOffset")),
-			normalDependsX(JsonUtils::mb_read_field<true>(item, "xDepends")),
-			shape(JsonUtils::read_enum<Shape>(item["Figure"], "shape")),
-			count(JsonUtils::mb_read_field<1u>(item["Figure"], "count")),
-			size(shape != Shape::Single ? static_cast<float>(JsonUtils::mb_read_field<0u>(item["Figure"], "size")) : 0)
-		{}
+		explicit Pattern(const Json::Value& item) : Pattern(item, true) {}
 
 		static RE::NiPoint3 rotateDependsX(const RE::NiPoint3& A, RE::Projectile::ProjectileRot parallel_rot, bool dependsX)
 		{
@@ -62,16 +56,7 @@ namespace Positioning
 
 		// By default center is in getposition.
 		// Use bone position if possible, as wel as shift it to pos_offset
-		void initCenter(RE::NiPoint3& center, const RE::Projectile::ProjectileRot& rot, RE::TESObjectREFR* origin_refr) const
-		{
-			if (!origin.empty()) {
-				auto root = origin_refr->Get3D1(origin_refr->IsPlayerRef() && !origin_refr->Is3rdPersonVisible());
-				if (auto bone = root->GetObjectByName(origin)) {
-					center = bone->world.translate;
-				}
-			}
-			center += rotateDependsX(pos_offset, rot);
-		}
+		void initCenter(RE::NiPoint3& center, const RE::Projectile::ProjectileRot& rot, RE::TESObjectREFR* origin_refr) const;
 
 		// Get actual pattern direction, uses normal to rotate initial cast direction
 		RE::NiPoint3 getCastDir(const RE::Projectile::ProjectileRot& parallel_rot) const
@@ -80,6 +65,25 @@ namespace Positioning
 		}
 
 	private:
+		// Children are baked into the table of the parent, so they are static
+		Pattern(const Json::Value& item, bool animated) :
+			origin(JsonUtils::mb_getString(item, "origin")),
+			normal(JsonUtils::mb_getPoint3<RE::NiPoint3(0, 1, 0)>(item, "normal")),
+			rotate_alpha(JsonUtils::mb_getFloat(item, "planeRotate") * 3.14159265358f / 180.0f),
+			pos_offset(JsonUtils::mb_getPoint3(item, "posOffset")),
+			normalDependsX(JsonUtils::mb_read_field<true>(item, "xDepends")),
+			shape(JsonUtils::read_enum<Shape>(item["Figure"], "shape")),
+			count(JsonUtils::mb_read_field<1u>(item["Figure"], "count")),
+			size(shape != Shape::Single ? static_cast<float>(JsonUtils::mb_read_field<0u>(item["Figure"], "size")) : 0)
+		{
+			initTable(item["Figure"]);
+
+			if (item.isMember("Child"))
+				initChild(item["Child"]);
+
+			anim_ind = animated ? read_animation(item) : 0;
+		}
+
 		Shape shape: 4;
 		uint32_t count: 27;
 		uint32_t normalDependsX: 1;  // 2C used for armageddon
@@ -88,6 +92,8 @@ namespace Positioning
 		RE::NiPoint3 normal;       // 10 determines a pane of SP
 		float rotate_alpha;        // 1C rotate everything along the plane normal
 		RE::NiPoint3 pos_offset;   // 20 offset of SP center from actual cast pos
+		uint32_t table_ind: 16;    // 2C baked local positions
+		uint32_t anim_ind: 16;     // 2C:16 animation, 0 if static
 
 		RE::NiPoint3 GetPosition_Single(const Plane& plane, size_t) const;
 		RE::NiPoint3 GetPosition_Line(const Plane& plane, size_t ind) const;
@@ -99,6 +105,32 @@ namespace Positioning
 		RE::NiPoint3 GetPosition_Sphere(const Plane& plane, size_t ind) const;
 		RE::NiPoint3 GetPosition_HalfSphere(const Plane& plane, size_t ind) const;
 		RE::NiPoint3 GetPosition_Cylinder(const Plane& plane, size_t) const;
+		RE::NiPoint3 GetPosition_Custom(const Plane& plane, size_t ind) const;
+		RE::NiPoint3 GetPosition_Composite(const Plane& plane, size_t ind) const;
+
+		// Baked or mapped table of the figure, Single if there is none
+		void initTable(const Json::Value& figure);
+
+		// Local positions with rotate_alpha applied, shared by patterns with the same figure.
+		// nullopt if there are too many tables
+		std::optional<uint32_t> bake() const;
+
+		// The point at the start, for patterns without a valid table
+		void setSingle();
+
+		// Maps the points file of the figure, falls back to Single if it is invalid
+		void initCustom(const Json::Value& figure);
+
+		// Local positions of the table with size and rotate_alpha applied
+		Positions getBakedLocal() const;
+
+		// Places the child figure at every point, the child shares the plane of the pattern
+		void initChild(const Json::Value& item);
+
+		// Index of the animation of the pattern, 0 if it has no one
+		static uint32_t read_animation(const Json::Value& item);
+
+		void GetPositions(const Plane& plane, Positions& out, const Animation* anim, double time) const;
 
 		// Rotate point of the figure
 		RE::NiPoint3 rotateFigure(const RE::NiPoint3& P, const RE::NiPoint3& O, const RE::NiPoint3& axis) const
@@ -130,6 +162,10 @@ namespace Positioning
 				return GetPosition_HalfSphere(plane, ind);
 			case Positioning::Shape::Cylinder:
 				return GetPosition_Cylinder(plane, ind);
+			case Positioning::Shape::Custom:
+				return GetPosition_Custom(plane, ind);
+			case Positioning::Shape::Composite:
+				return GetPosition_Composite(plane, ind);
 			case Positioning::Shape::Single:
 			case Positioning::Shape::Total:
 			default:
@@ -148,15 +184,12 @@ namespace Positioning
 			return rotateFigure(GetPosition_(plane, ind), plane.startPos, cast_dir);
 		}
 
-		std::vector<RE::NiPoint3> GetPositions(const RE::NiPoint3& start_pos, const RE::NiPoint3& cast_dir) const
-		{
-			std::vector<RE::NiPoint3> ans;
-			Plane plane(start_pos, cast_dir);
-			for (size_t i = 0; i < count; i++) {
-				ans.push_back(GetPosition(plane, cast_dir, i));
-			}
-			return ans;
-		}
+		// All `count` points at once from the baked table, same as GetPosition for every index.
+		// The plane must be made from a unit cast_dir
+		void GetPositions(const Plane& plane, Positions& out) const { GetPositions(plane, out, nullptr, 0.0); }
+
+		// Same, animated at the game `time`
+		void GetPositions(const Plane& plane, Positions& out, double time) const;
 		
 		bool xDepends() const { return normalDependsX; }
 
@@ -165,4 +198,10 @@ namespace Positioning
 		bool isShapeless() const { return shape == Shape::Single; }
 	};
 	static_assert(sizeof(Pattern) == 0x30);
+
+	// Drops baked tables and animations, patterns must be read again
+	void clear();
+
+	// Logs the memory used by baked tables
+	void log_tables();
 }
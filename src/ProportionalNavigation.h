@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cmath>
+
+// Proportional navigation: the velocity turns proportionally to the rotation speed of the line of sight,
+// no intercept point is needed. Has no game dependencies, `Vec` is any type with float members x, y, z
+namespace ProportionalNavigation
+{
+	// Turns `vel` for `dtime` keeping its length, `gain` is the navigation constant (3..5 is usual).
+	// False if the target is too close to have a line of sight, `vel` is unchanged then
+	template <typename Vec>
+	bool steer(const Vec& pos, Vec& vel, const Vec& target_pos, const Vec& target_vel, float gain, float dtime)
+	{
+		float rx = target_pos.x - pos.x, ry = target_pos.y - pos.y, rz = target_pos.z - pos.z;
+		float R2 = rx * rx + ry * ry + rz * rz;
+		if (R2 < 1.0f)
+			return false;
+
+		// Rotation speed of the line of sight
+		float ux = target_vel.x - vel.x, uy = target_vel.y - vel.y, uz = target_vel.z - vel.z;
+		float wx = (ry * uz - rz * uy) / R2, wy = (rz * ux - rx * uz) / R2, wz = (rx * uy - ry * ux) / R2;
+
+		float speed = std::sqrt(vel.x * vel.x + vel.y * vel.y + vel.z * vel.z);
+		float k = gain * dtime;
+		float ax = wy * vel.z - wz * vel.y, ay = wz * vel.x - wx * vel.z, az = wx * vel.y - wy * vel.x;
+		vel.x += ax * k;
+		vel.y += ay * k;
+		vel.z += az * k;
+
+		if (float newspeed = std::sqrt(vel.x * vel.x + vel.y * vel.y + vel.z * vel.z); newspeed > 0.0f) {
+			float m = speed / newspeed;
+			vel.x *= m;
+			vel.y *= m;
+			vel.z *= m;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+// Spreads target searches over frames. At most MAX_SCANS_PER_FRAME searches are granted per frame,
+// and every projectile waits its `retargetInterval` between searches.
+// The oldest waiters that still ask get reserved slots, the rest of slots are granted in order of asking.
+// Has no game dependencies: projectiles are given by id (formID) and an owner pointer that is only compared.
+class ReacquireScheduler
+{
+public:
+	static constexpr uint32_t MAX_SCANS_PER_FRAME = 8;
+	static constexpr uint32_t LIVE_FRAMES = 8;     // a waiter that did not ask for that long loses its place
+	static constexpr uint32_t FORGET_FRAMES = 60;  // forget projectiles that did not ask for that long
+
+	// Whether `id` may search in `frame`. Must be called with non-decreasing `frame` and `time`
+	bool try_acquire(uint32_t id, const void* owner, float interval, uint32_t frame, float time)
+	{
+		if (cur_frame != frame)
+			new_frame(frame);
+
+		auto [found, inserted] = entries.insert({ id, Entry{ owner, -1.0E9f, 0, frame } });
+		auto& entry = found->second;
+		if (!inserted && entry.owner != owner) {
+			// formID is reused by a new projectile
+			if (entry.ticket)
+				drop_ticket(entry);
+			entry = Entry{ owner, -1.0E9f, 0, frame };
+		}
+		entry.last_asked = frame;
+
+		if (time - entry.last_scan < interval)
+			return false;
+
+		if (!entry.ticket) {
+			entry.ticket = next_ticket++;
+			queue.insert({ entry.ticket, id });
+		}
+
+		if (granted >= MAX_SCANS_PER_FRAME)
+			return false;
+
+		bool reserved = entry.ticket <= cutoff;
+		if (!reserved && granted + reserved_pending >= MAX_SCANS_PER_FRAME)
+			return false;
+
+		granted++;
+		drop_ticket(entry);
+		entry.last_scan = time;
+		return true;
+	}
+
+	// The projectile is gone, frees its place at once
+	void remove(uint32_t id, const void* owner)
+	{
+		auto found = entries.find(id);
+		if (found == entries.end() || found->second.owner != owner)
+			return;
+
+		if (found->second.ticket)
+			drop_ticket(found->second);
+		entries.erase(found);
+	}
+
+	void clear()
+	{
+		entries.clear();
+		queue.clear();
+		cutoff = 0;
+		reserved_pending = 0;
+	}
+
+	size_t waiting() const { return queue.size(); }
+
+private:
+	struct Entry
+	{
+		const void* owner;  // only compared
+		float last_scan;
+		uint64_t ticket;  // position in the queue, 0 if not waiting
+		uint32_t last_asked;
+	};
+
+	void drop_ticket(Entry& entry)
+	{
+		if (entry.ticket <= cutoff && reserved_pending)
+			reserved_pending--;
+		queue.erase(entry.ticket);
+		entry.ticket = 0;
+	}
+
+	void new_frame(uint32_t frame)
+	{
+		cur_frame = frame;
+		granted = 0;
+
+		if (frame - last_forget >= FORGET_FRAMES) {
+			last_forget = frame;
+			std::erase_if(entries, [this, frame](const auto& item) {
+				const auto& entry = item.second;
+				if (frame - entry.last_asked < FORGET_FRAMES)
+					return false;
+				if (entry.ticket)
+					queue.erase(entry.ticket);
+				return true;
+			});
+		}
+
+		// Reserve slots for the oldest waiters that asked recently, ones that stopped asking lose their place
+		cutoff = 0;
+		reserved_pending = 0;
+		for (auto it = queue.begin(); it != queue.end() && reserved_pending < MAX_SCANS_PER_FRAME;) {
+			auto& entry = entries.find(it->second)->second;
+			if (frame - entry.last_asked > LIVE_FRAMES) {
+				entry.ticket = 0;
+				it = queue.erase(it);
+				continue;
+			}
+
+			cutoff = it->first;
+			reserved_pending++;
+			++it;
+		}
+	}
+
+	std::unordered_map<uint32_t, Entry> entries;
+	std::map<uint64_t, uint32_t> queue;  // ticket -> id
+	uint64_t next_ticket = 1;
+	uint64_t cutoff = 0;            // tickets up to it have reserved slots in this frame
+	uint32_t reserved_pending = 0;  // reserved slots not taken yet
+	uint32_t cur_frame = 0;
+	uint32_t last_forget = 0;
+	uint32_t granted = 0;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <emmintrin.h>
+
+// SSE geometry, 4 vectors at once stored as a structure of arrays. Has no game dependencies
+namespace SIMD
+{
+	constexpr size_t WIDTH = 4;
+
+	struct Vec3x4
+	{
+		__m128 x, y, z;
+	};
+
+	inline Vec3x4 load(const float* x, const float* y, const float* z)
+	{
+		return { _mm_loadu_ps(x), _mm_loadu_ps(y), _mm_loadu_ps(z) };
+	}
+
+	// `Vec` is any type with float x, y, z, like RE::NiPoint3
+	template <typename Vec>
+	inline Vec3x4 broadcast(const Vec& a)
+	{
+		return { _mm_set1_ps(a.x), _mm_set1_ps(a.y), _mm_set1_ps(a.z) };
+	}
+
+	inline void store(const Vec3x4& a, float* x, float* y, float* z)
+	{
+		_mm_storeu_ps(x, a.x);
+		_mm_storeu_ps(y, a.y);
+		_mm_storeu_ps(z, a.z);
+	}
+
+	inline Vec3x4 add(const Vec3x4& a, const Vec3x4& b)
+	{
+		return { _mm_add_ps(a.x, b.x), _mm_add_ps(a.y, b.y), _mm_add_ps(a.z, b.z) };
+	}
+
+	inline Vec3x4 sub(const Vec3x4& a, const Vec3x4& b)
+	{
+		return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+	}
+
+	inline Vec3x4 mul(const Vec3x4& a, __m128 k) { return { _mm_mul_ps(a.x, k), _mm_mul_ps(a.y, k), _mm_mul_ps(a.z, k) }; }
+
+	inline __m128 dot(const Vec3x4& a, const Vec3x4& b)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+	}
+
+	inline Vec3x4 cross(const Vec3x4& a, const Vec3x4& b)
+	{
+		return { _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+			_mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+			_mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x)) };
+	}
+
+	// `mask ? a : b` per lane
+	inline __m128 select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+	inline Vec3x4 select(__m128 mask, const Vec3x4& a, const Vec3x4& b)
+	{
+		return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) };
+	}
+
+	// sin and cos of 4 angles at once, Cephes polynomials after reduction to [-pi/4, pi/4].
+	// Error is about 1e-7 for |x| < 8192, larger angles lose precision
+	inline void sincos(__m128 x, __m128& s, __m128& c)
+	{
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		__m128 sign_sin = _mm_and_ps(x, sign);
+		x = _mm_andnot_ps(sign, x);
+
+		// Octant j is rounded up to even, so x - j * pi/4 is in [-pi/4, pi/4]
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(j);
+
+		__m128 swap_sin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+		__m128 sign_cos =
+			_mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		// Octants 2 and 6 (mod 8) swap the polynomials of sin and cos
+		__m128 direct = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		sign_sin = _mm_xor_ps(sign_sin, swap_sin);
+
+		// pi/4 is split in three parts, the reduction stays exact
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		__m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(-1.388731625493765e-3f));
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+		pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+		pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		__m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+		ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+		ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+		ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+
+		s = _mm_xor_ps(select(direct, ps, pc), sign_sin);
+		c = _mm_xor_ps(select(direct, pc, ps), sign_cos);
+	}
+
+	// Same as NiPoint3::UnitCross, zero for parallel vectors
+	inline Vec3x4 UnitCross(const Vec3x4& a, const Vec3x4& b)
+	{
+		auto c = cross(a, b);
+		__m128 len2 = dot(c, c);
+		__m128 nonzero = _mm_cmpgt_ps(len2, _mm_setzero_ps());
+		__m128 inv_len = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len2));
+		return select(nonzero, mul(c, inv_len), { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() });
+	}
+
+	// Same as FenixUtils::Geom::rotate: rotates `P` around the line through `O` along unit `axis` by the angle,
+	// given by its cos and sin (Rodrigues' formula)
+	inline Vec3x4 rotate(const Vec3x4& P, __m128 cos_a, __m128 sin_a, const Vec3x4& O, const Vec3x4& axis)
+	{
+		auto v = sub(P, O);
+		__m128 k = _mm_mul_ps(dot(axis, v), _mm_sub_ps(_mm_set1_ps(1.0f), cos_a));
+		return add(O, add(add(mul(v, cos_a), mul(cross(axis, v), sin_a)), mul(axis, k)));
+	}
+
+	// Same as FenixUtils::Geom::rotateVel: turns `A` towards `B` by at most the angle `phi`, keeping the length of `A`
+	inline Vec3x4 rotateVel(const Vec3x4& A, __m128 cos_phi, __m128 sin_phi, const Vec3x4& B)
+	{
+		__m128 one = _mm_set1_ps(1.0f);
+		__m128 lenA = _mm_sqrt_ps(dot(A, A));
+		__m128 lenB = _mm_sqrt_ps(dot(B, B));
+		__m128 cos_ab = _mm_div_ps(dot(A, B), _mm_mul_ps(lenA, lenB));
+
+		auto reached = mul(B, _mm_div_ps(lenA, lenB));
+		auto axis = UnitCross(A, B);
+		auto turned = rotate(A, cos_phi, sin_phi, { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() }, axis);
+
+		// Close enough or opposite (no axis): same as the scalar version, just take `B`
+		__m128 take_B = _mm_or_ps(_mm_cmpge_ps(cos_ab, cos_phi), _mm_cmpeq_ps(dot(axis, axis), _mm_setzero_ps()));
+		take_B = _mm_or_ps(take_B, _mm_cmpge_ps(cos_ab, one));
+		return select(take_B, reached, turned);
+	}
+
+	// Same as Positioning::Plane, the origin is at zero
+	struct Plane
+	{
+		Vec3x4 right, up;
+
+		// `cast_dir` must be unit
+		explicit Plane(const Vec3x4& cast_dir)
+		{
+			__m128 zero = _mm_setzero_ps();
+			__m128 one = _mm_set1_ps(1.0f);
+			right = UnitCross({ zero, zero, _mm_set1_ps(-1.0f) }, cast_dir);
+			right = select(_mm_cmpeq_ps(dot(right, right), zero), { one, zero, zero }, right);
+			up = cross(right, cast_dir);
+		}
+
+		void project(const Vec3x4& P, __m128& x, __m128& y) const
+		{
+			x = dot(P, right);
+			y = dot(P, up);
+		}
+
+		Vec3x4 unproject(__m128 x, __m128 y) const { return add(mul(right, x), mul(up, y)); }
+	};
+}
@@ -0,0 +1,38 @@
+#include "Settings.h"
+#include "JsonUtils.h"
+
+namespace Settings
+{
+	static Data data;
+
+	const Data& get() { return data; }
+
+	void clear() { data = Data{}; }
+
+	void init(const std::string&, const Json::Value& json_root)
+	{
+		if (!json_root.isMember("Settings"))
+			return;
+
+		const auto& item = json_root["Settings"];
+		if (item.isMember("maxFollowersPerCaster"))
+			data.max_followers = item["maxFollowersPerCaster"].asUInt();
+		if (item.isMember("maxFollowersEviction"))
+			data.followers_eviction = JsonUtils::read_enum<EvictionPolicy::Eviction>(item, "maxFollowersEviction");
+
+		if (item.isMember("logStats"))
+			data.log_stats = item["logStats"].asBool();
+
+		if (item.isMember("LOD")) {
+			const auto& lod = item["LOD"];
+			if (lod.isMember("midDistance"))
+				data.lod_mid_distance = lod["midDistance"].asFloat();
+			if (lod.isMember("farDistance"))
+				data.lod_far_distance = lod["farDistance"].asFloat();
+			if (lod.isMember("midRate"))
+				data.lod_mid_rate = lod["midRate"].asUInt();
+			if (lod.isMember("farRate"))
+				data.lod_far_rate = lod["farRate"].asUInt();
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "json/json.h"
+#include "EvictionPolicy.h"
+
+namespace Settings
+{
+	// Global tweaks from the "Settings" section. Later files override fields of earlier ones
+	struct Data
+	{
+		uint32_t max_followers = 0;  // per caster, 0 for unlimited
+		EvictionPolicy::Eviction followers_eviction = EvictionPolicy::Eviction::Oldest;  // if max_followers is reached
+
+		// Steering LOD: farther projectiles are steered every `rate`-th frame, disabled if lod_mid_distance is 0
+		float lod_mid_distance = 0.0f;
+		float lod_far_distance = 0.0f;
+		uint32_t lod_mid_rate = 2;
+		uint32_t lod_far_rate = 4;
+
+		bool log_stats = false;  // write performance counters to the log every 10 seconds
+	};
+
+	const Data& get();
+
+	void clear();
+	void init(const std::string& filename, const Json::Value& json_root);
+}
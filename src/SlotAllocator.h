@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Pattern slots of one (caster, follower type), the lowest free slot first. Has no game dependencies
+class SlotAllocator
+{
+public:
+	static constexpr uint32_t NONE = static_cast<uint32_t>(-1);
+
+	// Lowest free slot below `size`, NONE if all are taken
+	uint32_t claim(uint32_t size)
+	{
+		for (uint32_t w = hint; w * 64 < size; w++) {
+			if (w == words.size())
+				words.push_back(0);
+
+			if (~words[w]) {
+				uint32_t bit = std::countr_one(words[w]);
+				uint32_t slot = w * 64 + bit;
+				if (slot >= size)
+					return NONE;
+
+				words[w] |= 1ull << bit;
+				hint = w;
+				count++;
+				return slot;
+			}
+		}
+		return NONE;
+	}
+
+	// Marks `slot` as taken, for followers that keep their slot while the state is made again
+	void take(uint32_t slot)
+	{
+		if (slot / 64 >= words.size())
+			words.resize(slot / 64 + 1);
+
+		auto bit = 1ull << (slot % 64);
+		if (words[slot / 64] & bit)
+			return;
+
+		words[slot / 64] |= bit;
+		count++;
+	}
+
+	void release(uint32_t slot)
+	{
+		words[slot / 64] &= ~(1ull << (slot % 64));
+		hint = std::min(hint, slot / 64);
+		count--;
+	}
+
+	bool empty() const { return count == 0; }
+
+	uint32_t size() const { return count; }
+
+private:
+	std::vector<uint64_t> words;  // set bit is a taken slot
+	uint32_t hint = 0;            // all words before it are full
+	uint32_t count = 0;
+};
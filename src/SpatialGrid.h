@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Uniform 2d grid of points (xy plane, z is ignored while bucketing).
+// Has no game dependencies: `Entry` is any type with a member `pos` of float x, y, z
+template <typename Entry>
+class SpatialGrid
+{
+public:
+	static constexpr float CELL_SIZE = 1024.0f;
+
+	// Cells are stored densely over the bounding box, wider boxes fall back to the linear scan
+	static constexpr int64_t MAX_CELLS = 1 << 16;
+
+	// Fewer entries are cheaper to scan linearly than to walk cells (see tests/SpatialGridBench)
+	static constexpr size_t LINEAR_MAX = 128;
+
+	void build(std::vector<Entry> new_entries)
+	{
+		entries.clear();
+		starts.clear();
+		width = height = 0;
+
+		if (new_entries.empty())
+			return;
+
+		std::vector<std::pair<int32_t, int32_t>> cell_of;
+		cell_of.reserve(new_entries.size());
+		min_x = min_y = std::numeric_limits<int32_t>::max();
+		int32_t max_x = std::numeric_limits<int32_t>::min(), max_y = std::numeric_limits<int32_t>::min();
+		for (const auto& entry : new_entries) {
+			auto [x, y] = get_cell(entry.pos.x, entry.pos.y);
+			cell_of.push_back({ x, y });
+			min_x = std::min(min_x, x);
+			min_y = std::min(min_y, y);
+			max_x = std::max(max_x, x);
+			max_y = std::max(max_y, y);
+		}
+
+		if ((int64_t(max_x) - min_x + 1) * (int64_t(max_y) - min_y + 1) > MAX_CELLS) {
+			entries = std::move(new_entries);
+			return;
+		}
+
+		// Counting sort by (y, x), so a row of cells is one range of entries
+		width = max_x - min_x + 1;
+		height = max_y - min_y + 1;
+		starts.assign(size_t(width) * height + 1, 0);
+		for (auto [x, y] : cell_of) {
+			starts[index(x, y) + 1]++;
+		}
+		for (size_t i = 1; i < starts.size(); i++) {
+			starts[i] += starts[i - 1];
+		}
+
+		auto next = starts;
+		entries.resize(new_entries.size());
+		for (size_t i = 0; i < new_entries.size(); i++) {
+			entries[next[index(cell_of[i].first, cell_of[i].second)]++] = std::move(new_entries[i]);
+		}
+	}
+
+	const std::vector<Entry>& get_entries() const { return entries; }
+
+	// Calls `func(const Entry&)` for every entry closer than `radius` to `origin`
+	template <typename Point, typename F>
+	void forEachInRadius(const Point& origin, float radius, F&& func) const
+	{
+		const float radius2 = radius * radius;
+		auto visit = [&origin, radius2, &func](const Entry& entry) {
+			if (dist2(origin, entry.pos) < radius2)
+				func(entry);
+		};
+
+		auto [x0, y0] = get_cell(origin.x - radius, origin.y - radius);
+		auto [x1, y1] = get_cell(origin.x + radius, origin.y + radius);
+
+		if (width) {
+			x0 = std::max(x0, min_x);
+			y0 = std::max(y0, min_y);
+			x1 = std::min(x1, min_x + width - 1);
+			y1 = std::min(y1, min_y + height - 1);
+			if (x0 > x1 || y0 > y1)
+				return;
+		}
+
+		// No dense cells, few entries or the radius covers more cells than we have entries: cheaper to check everything
+		if (!width || entries.size() <= LINEAR_MAX ||
+			(int64_t(x1) - x0 + 1) * (int64_t(y1) - y0 + 1) > (int64_t)entries.size()) {
+			for (const auto& entry : entries) {
+				visit(entry);
+			}
+			return;
+		}
+
+		for (int32_t y = y0; y <= y1; y++) {
+			for (uint32_t i = starts[index(x0, y)]; i < starts[index(x1, y) + 1]; i++) {
+				visit(entries[i]);
+			}
+		}
+	}
+
+	// Calls `func(const Entry&)` for every entry within `radius` whose `get_point(const Entry&)` is strictly inside the cone.
+	// `dir` must be unit, `cos_max` is a cos of the half-angle of the cone
+	template <typename Point, typename GetPoint, typename F>
+	void forEachInCone(const Point& apex, const Point& dir, float cos_max, float radius, GetPoint&& get_point, F&& func) const
+	{
+		forEachInRadius(apex, radius, [&apex, &dir, cos_max, &get_point, &func](const Entry& entry) {
+			if (in_cone(apex, dir, cos_max, get_point(entry)))
+				func(entry);
+		});
+	}
+
+	// Same, the cone is tested against entries positions
+	template <typename Point, typename F>
+	void forEachInCone(const Point& apex, const Point& dir, float cos_max, float radius, F&& func) const
+	{
+		forEachInCone(apex, dir, cos_max, radius, [](const Entry& entry) { return entry.pos; }, func);
+	}
+
+	// acos(cos) < angle <=> cos > cos_max
+	template <typename Point, typename P>
+	static bool in_cone(const Point& apex, const Point& dir, float cos_max, const P& p)
+	{
+		float dx = p.x - apex.x, dy = p.y - apex.y, dz = p.z - apex.z;
+		return dx * dir.x + dy * dir.y + dz * dir.z > cos_max * std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+private:
+	template <typename A, typename B>
+	static float dist2(const A& a, const B& b)
+	{
+		float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	static std::pair<int32_t, int32_t> get_cell(float x, float y)
+	{
+		return { static_cast<int32_t>(std::floor(x / CELL_SIZE)), static_cast<int32_t>(std::floor(y / CELL_SIZE)) };
+	}
+
+	size_t index(int32_t x, int32_t y) const { return size_t(y - min_y) * width + (x - min_x); }
+
+	std::vector<Entry> entries;     // sorted by cells, rows of cells are contiguous
+	std::vector<uint32_t> starts;   // cell index -> first entry, one extra at the end
+	int32_t min_x = 0, min_y = 0;   // bounding box of cells
+	int32_t width = 0, height = 0;  // zero if cells are not built
+};
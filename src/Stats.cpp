@@ -0,0 +1,79 @@
+#include "Stats.h"
+#include "Settings.h"
+#include "magic_enum.hpp"
+
+namespace Stats
+{
+	constexpr float REPORT_INTERVAL = 10.0f;
+
+	// Pairs of counters reported as a hit rate
+	struct HitRate
+	{
+		Counter hit;
+		Counter miss;
+		std::string_view name;
+	};
+	constexpr HitRate HIT_RATES[] = {
+		{ Counter::TargetCacheHit, Counter::TargetCacheMiss, "TargetCache"sv },
+		{ Counter::LOSCacheHit, Counter::LOSRaycast, "LOSCache"sv },
+		{ Counter::HostilityHit, Counter::HostilityMiss, "HostilityCache"sv },
+		{ Counter::KinematicsHit, Counter::KinematicsMiss, "Kinematics"sv },
+		{ Counter::HomingBatched, Counter::HomingScalar, "HomingBatch"sv },
+		{ Counter::FormationHit, Counter::FormationMiss, "Formations"sv },
+		{ Counter::BoneCacheHit, Counter::BoneCacheMiss, "BoneCache"sv },
+		{ Counter::NodeRotationSkipped, Counter::NodeRotationUpdated, "NodeRotationSkip"sv },
+		{ Counter::OrbitsBatched, Counter::OrbitsScalar, "OrbitsBatch"sv },
+	};
+
+	static std::array<uint64_t, (uint32_t)Counter::Total> counters;
+	static uint32_t frames = 0;
+	static float last_report = 0.0f;
+	static bool enabled = false;  // the setting as of the last frame
+
+	void inc(Counter counter, uint32_t val)
+	{
+		if (enabled)
+			counters[(uint32_t)counter] += val;
+	}
+
+	static void report()
+	{
+		bool any = false;
+		for (uint32_t i = 0; i < counters.size(); i++) {
+			if (auto val = counters[i]) {
+				any = true;
+				logger::info("{}: {} ({:.2f} per frame)"sv, magic_enum::enum_name(static_cast<Counter>(i)), val,
+					static_cast<double>(val) / frames);
+			}
+		}
+
+		if (!any)
+			return;
+
+		for (const auto& rate : HIT_RATES) {
+			auto hit = counters[(uint32_t)rate.hit];
+			auto total = hit + counters[(uint32_t)rate.miss];
+			if (total) {
+				logger::info("{} hit rate: {:.1f}%"sv, rate.name, 100.0 * hit / total);
+			}
+		}
+	}
+
+	void on_frame(float time)
+	{
+		enabled = Settings::get().log_stats;
+		if (!enabled)
+			return;
+
+		frames++;
+
+		if (time - last_report < REPORT_INTERVAL)
+			return;
+
+		report();
+
+		counters.fill(0);
+		frames = 0;
+		last_report = time;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace Stats
+{
+	enum class Counter : uint32_t
+	{
+		TargetCacheHit,
+		TargetCacheMiss,
+		LOSCacheHit,
+		LOSRaycast,
+		HostilityHit,
+		HostilityMiss,
+		KinematicsHit,
+		KinematicsMiss,
+		HomingBatched,
+		HomingScalar,
+		FormationHit,
+		FormationMiss,
+		BoneCacheHit,
+		BoneCacheMiss,
+		LODNear,
+		LODMid,
+		LODFar,
+		LODSkipped,
+		NodeRotationSkipped,
+		NodeRotationUpdated,
+		OrbitsBatched,
+		OrbitsScalar,
+
+		Total  // for std::array
+	};
+
+	// Does nothing unless the "logStats" setting is on
+	void inc(Counter counter, uint32_t val = 1);
+
+	// Called once per frame, periodically writes counters to the log and resets them if the "logStats" setting is on
+	void on_frame(float time);
+}
@@ -0,0 +1,28 @@
+#include "TargetScanner.h"
+#include "ActorsIndex.h"
+
+namespace TargetScanner
+{
+	// Its destructor stops the worker: the game has no unload event, the worker is stopped with the plugin
+	static Scanner scanner;
+
+	void request(uint32_t id, const RE::NiPoint3& origin, float within_dist2, uint64_t filter_key, Filter filter)
+	{
+		scanner.request(id, origin, within_dist2, filter_key, std::move(filter));
+	}
+
+	bool is_waiting(uint32_t id) { return scanner.is_waiting(id); }
+
+	std::optional<std::vector<RE::ActorHandle>> take(uint32_t id) { return scanner.take(id); }
+
+	void on_frame()
+	{
+		scanner.on_frame(ActorsIndex::get().get_entries(), [](const auto& entry) {
+			return Scanner::Entry{ entry.actor, entry.actor->GetHandle(), entry.pos };
+		});
+	}
+
+	void install() { scanner.start(); }
+
+	void shutdown() { scanner.shutdown(); }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "AsyncScanner.h"
+
+// Distance scans of indexed actors for targeting, done on a worker thread one frame ahead, see AsyncScanner
+namespace TargetScanner
+{
+	using Scanner = AsyncScanner<RE::Actor, RE::ActorHandle, RE::NiPoint3>;
+
+	// Answers hold at most that many nearest actors
+	constexpr size_t MAX_CANDIDATES = Scanner::MAX_CANDIDATES;
+
+	// Which actors may be a target. Called on the main thread, once per indexed actor for every distinct `filter_key`
+	using Filter = Scanner::Filter;
+
+	// Asks for actors around `origin` that pass `filter`, the answer is available by the same id since the next frame.
+	// Requests with the same `filter_key` must have the same filter. Does nothing if `id` is already waiting
+	void request(uint32_t id, const RE::NiPoint3& origin, float within_dist2, uint64_t filter_key, Filter filter);
+
+	// Whether a request of `id` is not answered yet
+	bool is_waiting(uint32_t id);
+
+	// Actors sorted by distance (as they were at the scan), nullopt if the answer is not ready. Every answer is given once
+	std::optional<std::vector<RE::ActorHandle>> take(uint32_t id);
+
+	// Main thread, once per frame: publishes finished scans and starts pending ones
+	void on_frame();
+
+	void install();
+
+	// Stops and joins the worker, pending requests are dropped
+	void shutdown();
+}
@@ -53,6 +53,9 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Query(const SKSE::QueryInterface* a
 #include "Homing.h"
 #include "Emitters.h"
 #include "Followers.h"
+#include "PerFrame.h"
+#include "Settings.h"
+#include "Positioning.h"
 
 #include <nlohmann/json-schema.hpp>
 
@@ -81,10 +84,12 @@ void read_json()
 {
 	JsonUtils::FormIDsMap::clear();
 
+	Settings::clear();
 	Homing::clear();
 	Multicast::clear();
 	Emitters::clear();
 	Followers::clear();
+	Positioning::clear();
 
 	Triggers::clear();
 
@@ -101,6 +106,7 @@ void read_json()
 				auto filename = entry.path().filename().string();
 
 				JsonUtils::FormIDsMap::init(filename, json_root);
+				Settings::init(filename, json_root);
 
 				Homing::init_keys(filename, json_root);
 				Multicast::init_keys(filename, json_root);
@@ -122,6 +128,8 @@ void read_json()
 	Multicast::clear_keys();
 	Emitters::clear_keys();
 	Followers::clear_keys();
+
+	Positioning::log_tables();
 }
 
 void reset_json()
@@ -186,6 +194,7 @@ static void SKSEMessageHandler(SKSE::MessagingInterface::Message* message)
 	case SKSE::MessagingInterface::kDataLoaded:
 		Hooks::MultipleBeamsHook::Hook();
 		Hooks::NormLightingsHook::Hook();
+		PerFrame::install();
 		Triggers::install();
 		Homing::install();
 		Multicast::install();
@@ -0,0 +1,254 @@
+#include "BonesCache.h"
+#include "Check.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cached nodes against a fake scene graph that changes under them
+namespace
+{
+	struct Node
+	{
+		std::string name;
+		Node* parent = nullptr;
+		std::vector<Node*> children;
+	};
+
+	struct NodePtr
+	{
+		Node* node = nullptr;
+
+		NodePtr() = default;
+		explicit NodePtr(Node* node) : node(node) {}
+
+		Node* get() const { return node; }
+		explicit operator bool() const { return node; }
+	};
+
+	struct Refr
+	{
+		uint32_t formID;
+		std::shared_ptr<Refr*> handle;  // empty once the refr is deleted
+	};
+
+	int finds = 0;  // lookups by name, one per miss
+
+	struct Traits
+	{
+		using Node = ::Node;
+		using NodePtr = ::NodePtr;
+		using Refr = ::Refr;
+		using Handle = std::shared_ptr<Refr*>;
+		using Name = std::string;
+		using NameHash = std::hash<std::string>;
+
+		static Handle get_handle(Refr* refr) { return refr->handle; }
+		static Refr* get_refr(const Handle& handle) { return handle ? *handle : nullptr; }
+
+		static Node* find(Node* root, const Name& name)
+		{
+			finds++;
+			if (root->name == name)
+				return root;
+			for (auto child : root->children) {
+				if (auto ans = find(child, name))
+					return ans;
+			}
+			return nullptr;
+		}
+	};
+
+	using Cache = BonesCache<Traits>;
+
+	// Nodes of all 3D ever loaded, a held node outlives its 3D in the game too
+	struct Scene
+	{
+		std::vector<std::unique_ptr<Node>> all;
+		std::vector<std::unique_ptr<Refr>> refrs;
+
+		Node* add(const std::string& name, Node* parent = nullptr)
+		{
+			all.push_back(std::make_unique<Node>());
+			all.back()->name = name;
+			auto node = all.back().get();
+			if (parent)
+				attach(node, parent);
+			return node;
+		}
+
+		// Root -> Spine -> (Head, Hand)
+		Node* skeleton()
+		{
+			auto root = add("NPC Root");
+			auto spine = add("Spine", root);
+			add("Head", spine);
+			add("Hand", spine);
+			return root;
+		}
+
+		Refr* refr(uint32_t formID)
+		{
+			refrs.push_back(std::make_unique<Refr>());
+			auto ans = refrs.back().get();
+			*ans = { formID, std::make_shared<Refr*>(ans) };
+			return ans;
+		}
+
+		static void attach(Node* node, Node* parent)
+		{
+			node->parent = parent;
+			parent->children.push_back(node);
+		}
+
+		static void detach(Node* node)
+		{
+			std::erase(node->parent->children, node);
+			node->parent = nullptr;
+		}
+	};
+
+	Node* get(Cache& cache, Refr* refr, Node* root, const std::string& name, bool& hit, float now = 1.0f,
+		bool first_person = false)
+	{
+		return cache.get(refr, first_person, root, name, now, hit);
+	}
+
+	void test_hit()
+	{
+		Scene scene;
+		Cache cache;
+		auto root = scene.skeleton();
+		auto refr = scene.refr(0x14);
+
+		bool hit;
+		finds = 0;
+		auto head = get(cache, refr, root, "Head", hit);
+		CHECK(head && head->name == "Head" && !hit);
+		CHECK(get(cache, refr, root, "Head", hit) == head && hit);
+		CHECK(get(cache, refr, root, "Head", hit) == head && hit);
+		int after_miss = finds;
+		CHECK(get(cache, refr, root, "Hand", hit)->name == "Hand" && !hit);
+		CHECK(finds > after_miss);
+		CHECK(cache.size() == 2);
+
+		// Not found is looked up again every time
+		CHECK(!get(cache, refr, root, "Tail", hit) && !hit);
+		CHECK(!get(cache, refr, root, "Tail", hit) && !hit);
+	}
+
+	// 3D is loaded again with the same names, the old nodes are alive but under the old root
+	void test_swap()
+	{
+		Scene scene;
+		Cache cache;
+		auto refr = scene.refr(0x14);
+
+		bool hit;
+		auto old_root = scene.skeleton();
+		auto old_head = get(cache, refr, old_root, "Head", hit);
+
+		auto root = scene.skeleton();
+		auto head = get(cache, refr, root, "Head", hit);
+		CHECK(!hit && head != old_head && head->name == "Head");
+		CHECK(get(cache, refr, root, "Head", hit) == head && hit);
+
+		// A refr deleted and its formID reused has other 3D, even if the old one is passed
+		auto reused = scene.refr(0x14);
+		*refr->handle = nullptr;
+		CHECK(get(cache, reused, root, "Head", hit) == head && !hit);
+		CHECK(get(cache, reused, root, "Head", hit) == head && hit);
+	}
+
+	// A subtree is cut off (or moved to another 3D), its nodes are not under the root anymore
+	void test_detached()
+	{
+		Scene scene;
+		Cache cache;
+		auto root = scene.skeleton();
+		auto refr = scene.refr(0x14);
+
+		bool hit;
+		auto head = get(cache, refr, root, "Head", hit);
+		auto spine = head->parent;
+		Scene::detach(spine);
+		CHECK(!get(cache, refr, root, "Head", hit) && !hit);
+
+		// Moved under another 3D: walking up ends at the other root
+		auto other = scene.skeleton();
+		Scene::attach(spine, other);
+		CHECK(!get(cache, refr, root, "Head", hit) && !hit);
+
+		Scene::detach(spine);
+		Scene::attach(spine, root);
+		CHECK(get(cache, refr, root, "Head", hit) == head && !hit);
+		CHECK(get(cache, refr, root, "Head", hit) == head && hit);
+	}
+
+	// The player has first and third person 3D, both are cached apart and checked against their own roots
+	void test_person_switch()
+	{
+		Scene scene;
+		Cache cache;
+		auto third = scene.skeleton();
+		auto first = scene.skeleton();
+		auto player = scene.refr(0x14);
+
+		bool hit;
+		auto third_head = get(cache, player, third, "Head", hit, 1.0f, false);
+		auto first_head = get(cache, player, first, "Head", hit, 1.0f, true);
+		CHECK(third_head != first_head);
+
+		for (int i = 0; i < 3; i++) {
+			CHECK(get(cache, player, third, "Head", hit, 1.0f, false) == third_head && hit);
+			CHECK(get(cache, player, first, "Head", hit, 1.0f, true) == first_head && hit);
+		}
+		CHECK(cache.size() == 2);
+
+		// First person 3D is made again after the switch back, the third person entry is untouched
+		auto new_first = scene.skeleton();
+		auto new_first_head = get(cache, player, new_first, "Head", hit, 1.0f, true);
+		CHECK(!hit && new_first_head != first_head);
+		CHECK(get(cache, player, third, "Head", hit, 1.0f, false) == third_head && hit);
+	}
+
+	// Entries unused for PRUNE_INTERVAL are dropped, at most once per interval
+	void test_prune()
+	{
+		Scene scene;
+		Cache cache;
+		auto root = scene.skeleton();
+		auto refr = scene.refr(0x14);
+
+		bool hit;
+		get(cache, refr, root, "Head", hit, 0.5f);
+		get(cache, refr, root, "Hand", hit, 0.5f);
+		get(cache, refr, root, "Head", hit, 1.5f);
+		CHECK(cache.size() == 2);
+
+		get(cache, refr, root, "Spine", hit, 3.0f);  // prunes: Hand is unused for 2.5
+		CHECK(cache.size() == 2);
+		CHECK(get(cache, refr, root, "Head", hit, 3.0f) && hit);
+		CHECK(get(cache, refr, root, "Hand", hit, 3.0f) && !hit);
+
+		get(cache, refr, root, "NPC Root", hit, 4.0f);  // too soon to prune
+		CHECK(cache.size() == 4);
+
+		CHECK(get(cache, refr, root, "Head", hit, 10.0f) && !hit);  // all were pruned before it
+		CHECK(cache.size() == 1);
+
+		cache.clear();
+		CHECK(cache.size() == 0);
+		CHECK(get(cache, refr, root, "Head", hit, 10.5f) && !hit);
+	}
+}
+
+int main()
+{
+	test_hit();
+	test_swap();
+	test_detached();
+	test_person_switch();
+	test_prune();
+	return check_result();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// Minimal checks, a test executable returns check_result() from main
+inline int check_failures = 0;
+
+#define CHECK(cond)                                                               \
+	do {                                                                          \
+		if (!(cond)) {                                                            \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			check_failures++;                                                     \
+		}                                                                         \
+	} while (0)
+
+#define CHECK_NEAR(a, b, eps)                                                                      \
+	do {                                                                                           \
+		double check_a_ = (a), check_b_ = (b);                                                     \
+		if (!(std::abs(check_a_ - check_b_) <= (eps))) {                                           \
+			std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, #a, #b, \
+				check_a_, check_b_);                                                               \
+			check_failures++;                                                                      \
+		}                                                                                          \
+	} while (0)
+
+inline int check_result()
+{
+	if (check_failures)
+		std::printf("%d checks failed\n", check_failures);
+	else
+		std::printf("OK\n");
+	return check_failures ? 1 : 0;
+}
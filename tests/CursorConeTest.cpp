@@ -0,0 +1,209 @@
+#include "Check.h"
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <random>
+
+// Cursor targets found with the cosine threshold over the grid cone query, as Homing::Targeting::Cursor does it,
+// against the acos predicate over the radius query and the nearest of collected candidates it replaced
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Entry
+	{
+		uint32_t id;
+		Vec pos;
+	};
+
+	using Grid = SpatialGrid<Entry>;
+
+	constexpr float HEAD = 120.0f;  // LOS location of the caster, above its position
+	constexpr float TORSO = 90.0f;  // LOS location of targets
+
+	Vec torso(const Entry& entry) { return { entry.pos.x, entry.pos.y, entry.pos.z + TORSO }; }
+
+	float dist2(const Vec& a, const Vec& b)
+	{
+		float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	Vec unit(Vec a)
+	{
+		float len = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+		return { a.x / len, a.y / len, a.z / len };
+	}
+
+	struct Scene
+	{
+		Vec caster_pos, apex, dir;
+		float angle_deg;
+		float within_dist2;
+		std::vector<Entry> entries;
+	};
+
+	// Actors around the caster, many of them along the sight so the cone has a lot to choose from
+	Scene random_scene(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> coord(-8000.0f, 8000.0f);
+		std::uniform_real_distribution<float> along(0.0f, 6000.0f);
+		std::uniform_real_distribution<float> spread(-600.0f, 600.0f);
+		std::uniform_real_distribution<float> height(-300.0f, 300.0f);
+		std::uniform_real_distribution<float> yaw(-3.1415926f, 3.1415926f);
+		std::uniform_real_distribution<float> pitch(-0.5f, 0.5f);
+		const float angles[] = { 3.0f, 10.0f, 25.0f, 60.0f };
+
+		Scene ans;
+		ans.caster_pos = { coord(rng), coord(rng), height(rng) };
+		ans.apex = { ans.caster_pos.x, ans.caster_pos.y, ans.caster_pos.z + HEAD };
+		float a = yaw(rng), b = pitch(rng);
+		ans.dir = unit({ std::cos(b) * std::sin(a), std::cos(b) * std::cos(a), -std::sin(b) });
+		ans.angle_deg = angles[rng() % std::size(angles)];
+		ans.within_dist2 = 4000.0f * 4000.0f;
+
+		for (uint32_t i = 0; i < 300; i++) {
+			Vec pos;
+			if (i % 3 == 0) {
+				pos = { coord(rng), coord(rng), height(rng) };
+			} else {
+				float t = along(rng);
+				pos = { ans.apex.x + ans.dir.x * t + spread(rng), ans.apex.y + ans.dir.y * t + spread(rng),
+					ans.apex.z + ans.dir.z * t + height(rng) };
+			}
+			ans.entries.push_back({ i, pos });
+		}
+		return ans;
+	}
+
+	// is_anglebetween_less as it was: both directions unitized, acos of their dot
+	bool acos_predicate(const Vec& A, const Vec& B1, const Vec& B2, float angle_deg)
+	{
+		auto AB1 = unit({ B1.x - A.x, B1.y - A.y, B1.z - A.z });
+		auto AB2 = unit({ B2.x - A.x, B2.y - A.y, B2.z - A.z });
+		return std::acos(AB1.x * AB2.x + AB1.y * AB2.y + AB1.z * AB2.z) < angle_deg / 180.0f * 3.1415926f;
+	}
+
+	// Within float error of the cone surface, the two predicates may disagree there
+	bool on_edge(const Scene& scene, const Vec& p)
+	{
+		double dx = p.x - scene.apex.x, dy = p.y - scene.apex.y, dz = p.z - scene.apex.z;
+		double len = std::sqrt(dx * dx + dy * dy + dz * dz);
+		double c = (dx * scene.dir.x + dy * scene.dir.y + dz * scene.dir.z) / len;
+		double angle = std::acos(std::clamp(c, -1.0, 1.0));
+		return std::abs(angle - scene.angle_deg / 180.0 * 3.1415926) < 1e-3;
+	}
+
+	struct Found
+	{
+		std::vector<uint32_t> all;  // get_cursor_targets
+		int32_t nearest = -1;       // find_cursor_target
+	};
+
+	// Radius query around the caster, acos predicate, candidates collected and the nearest taken
+	Found baseline(const Scene& scene, const Grid& grid)
+	{
+		Found ans;
+		std::vector<std::pair<float, uint32_t>> candidates;
+		auto sight = Vec{ scene.apex.x + scene.dir.x, scene.apex.y + scene.dir.y, scene.apex.z + scene.dir.z };
+		grid.forEachInRadius(scene.caster_pos, std::sqrt(scene.within_dist2), [&](const Entry& entry) {
+			float d2 = dist2(scene.caster_pos, entry.pos);
+			if (d2 < scene.within_dist2 && acos_predicate(scene.apex, sight, torso(entry), scene.angle_deg)) {
+				candidates.push_back({ d2, entry.id });
+				ans.all.push_back(entry.id);
+			}
+		});
+
+		auto less = [](const auto& a, const auto& b) { return a.first < b.first; };
+		if (!candidates.empty())
+			ans.nearest = std::min_element(candidates.begin(), candidates.end(), less)->second;
+		return ans;
+	}
+
+	// Cone query from the head with the cosine threshold, the nearest kept as we go
+	Found cone(const Scene& scene, const Grid& grid)
+	{
+		Found ans;
+		const float cos_max = std::cos(scene.angle_deg / 180.0f * 3.1415926f);
+		const float apex_height = HEAD;
+		float best_dist2 = std::numeric_limits<float>::max();
+		grid.forEachInCone(scene.apex, scene.dir, cos_max, std::sqrt(scene.within_dist2) + apex_height, torso,
+			[&](const Entry& entry) {
+				float d2 = dist2(scene.caster_pos, entry.pos);
+				if (d2 >= scene.within_dist2)
+					return;
+
+				ans.all.push_back(entry.id);
+				if (d2 < best_dist2) {
+					best_dist2 = d2;
+					ans.nearest = entry.id;
+				}
+			});
+		return ans;
+	}
+
+	void test_random_scenes()
+	{
+		std::mt19937 rng(10);
+		int same_nearest = 0, edge_nearest = 0, edge_actors = 0, found = 0;
+		constexpr int SCENES = 2000;
+		for (int s = 0; s < SCENES; s++) {
+			auto scene = random_scene(rng);
+			Grid grid;
+			grid.build(scene.entries);
+
+			auto a = baseline(scene, grid);
+			auto b = cone(scene, grid);
+			found += !a.all.empty();
+
+			// The same targets, except those on the very edge of the cone
+			std::sort(a.all.begin(), a.all.end());
+			std::sort(b.all.begin(), b.all.end());
+			std::vector<uint32_t> diff;
+			std::set_symmetric_difference(a.all.begin(), a.all.end(), b.all.begin(), b.all.end(), std::back_inserter(diff));
+			for (auto id : diff) {
+				CHECK(on_edge(scene, torso(scene.entries[id])));
+				edge_actors++;
+			}
+
+			// The same nearest one, or one of them is on the edge and the other is not nearer
+			if (a.nearest == b.nearest) {
+				same_nearest++;
+				continue;
+			}
+			edge_nearest++;
+			CHECK(!diff.empty());
+			bool explained = false;
+			for (auto id : diff) {
+				explained |= int32_t(id) == a.nearest || int32_t(id) == b.nearest;
+			}
+			CHECK(explained);
+		}
+		CHECK(found > SCENES / 2);
+		CHECK(edge_nearest <= SCENES / 100);
+		std::printf("%d scenes, %d with targets: same nearest in %d, differs on the edge in %d, %d edge actors\n", SCENES,
+			found, same_nearest, edge_nearest, edge_actors);
+	}
+
+	// Points right on the axis and right behind the apex, away from any edge
+	void test_predicate()
+	{
+		Vec apex{ 0, 0, 0 }, dir{ 0, 1, 0 }, sight{ 0, 1, 0 };
+		const float cos_max = std::cos(10.0f / 180.0f * 3.1415926f);
+		for (auto [p, inside] : { std::pair{ Vec{ 0, 100, 0 }, true }, { Vec{ 0, -100, 0 }, false },
+									{ Vec{ 100, 100, 0 }, false }, { Vec{ 10, 100, 0 }, true }, { Vec{ 0, 100, 20 }, false } }) {
+			CHECK(Grid::in_cone(apex, dir, cos_max, p) == inside);
+			CHECK(acos_predicate(apex, sight, p, 10.0f) == inside);
+		}
+	}
+}
+
+int main()
+{
+	test_predicate();
+	test_random_scenes();
+	return check_result();
+}
@@ -0,0 +1,99 @@
+#include "Check.h"
+#include "EvictionPolicy.h"
+
+using namespace EvictionPolicy;
+
+namespace
+{
+	constexpr uint32_t A = 1, B = 2;
+
+	std::vector<size_t> plan_victims(const std::vector<Follower>& followers, uint32_t type, const Caps& caps, bool& ok)
+	{
+		std::vector<size_t> victims;
+		ok = plan(followers, type, caps, victims);
+		return victims;
+	}
+
+	void test_no_caps()
+	{
+		bool ok;
+		auto victims = plan_victims({ { A, 1 }, { B, 2 } }, A, { 0, Eviction::RejectNew, 0, Eviction::RejectNew }, ok);
+		CHECK(ok);
+		CHECK(victims.empty());
+	}
+
+	void test_type_cap()
+	{
+		std::vector<Follower> followers{ { A, 1 }, { B, 100 }, { A, 50 }, { A, 10 } };
+		bool ok;
+
+		auto victims = plan_victims(followers, A, { 2, Eviction::Oldest, 0, Eviction::Oldest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 0, 2 }));
+
+		victims = plan_victims(followers, A, { 2, Eviction::Farthest, 0, Eviction::Oldest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 2, 3 }));
+
+		victims = plan_victims(followers, A, { 2, Eviction::RejectNew, 0, Eviction::Oldest }, ok);
+		CHECK(!ok);
+		CHECK(victims.empty());
+
+		// Other types are under their cap
+		victims = plan_victims(followers, B, { 2, Eviction::Oldest, 0, Eviction::Oldest }, ok);
+		CHECK(ok);
+		CHECK(victims.empty());
+	}
+
+	// The global cap uses the global policy, not the one of the new type
+	void test_global_cap()
+	{
+		std::vector<Follower> followers{ { B, 5 }, { B, 500 }, { A, 50 } };
+		bool ok;
+
+		auto victims = plan_victims(followers, A, { 0, Eviction::Farthest, 3, Eviction::Oldest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 0 }));
+
+		victims = plan_victims(followers, A, { 0, Eviction::Oldest, 3, Eviction::Farthest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 1 }));
+
+		// RejectNew of the type does not refuse because of other types
+		victims = plan_victims(followers, A, { 5, Eviction::RejectNew, 3, Eviction::Oldest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 0 }));
+
+		victims = plan_victims(followers, A, { 0, Eviction::Oldest, 3, Eviction::RejectNew }, ok);
+		CHECK(!ok);
+		CHECK(victims.empty());
+	}
+
+	// Victims of the type cap count for the global cap, a refused follower kills nobody
+	void test_both_caps()
+	{
+		std::vector<Follower> followers{ { A, 1 }, { B, 2 }, { A, 3 }, { B, 4 } };
+		bool ok;
+
+		auto victims = plan_victims(followers, A, { 2, Eviction::Oldest, 4, Eviction::Farthest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 0 }));
+
+		victims = plan_victims(followers, A, { 2, Eviction::Oldest, 3, Eviction::Farthest }, ok);
+		CHECK(ok);
+		CHECK((victims == std::vector<size_t>{ 0, 3 }));
+
+		victims = plan_victims(followers, A, { 2, Eviction::Oldest, 2, Eviction::RejectNew }, ok);
+		CHECK(!ok);
+		CHECK(victims.empty());
+	}
+}
+
+int main()
+{
+	test_no_caps();
+	test_type_cap();
+	test_global_cap();
+	test_both_caps();
+	return check_result();
+}
@@ -0,0 +1,375 @@
+#include "Check.h"
+#include "Figures.h"
+
+#include <chrono>
+#include <initializer_list>
+
+using namespace Figures;
+
+// Checks figures against the per-point formulas they replaced (Pattern::GetPosition_* with rotateFigure)
+// and prints timings of both and of baked tables
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+
+		Vec() = default;
+		Vec(float x, float y, float z) : x(x), y(y), z(z) {}
+
+		Vec operator+(const Vec& a) const { return { x + a.x, y + a.y, z + a.z }; }
+		Vec operator-(const Vec& a) const { return { x - a.x, y - a.y, z - a.z }; }
+		Vec operator*(float k) const { return { x * k, y * k, z * k }; }
+
+		float Dot(const Vec& a) const { return x * a.x + y * a.y + z * a.z; }
+		Vec Cross(const Vec& a) const { return { y * a.z - z * a.y, z * a.x - x * a.z, x * a.y - y * a.x }; }
+		Vec UnitCross(const Vec& a) const
+		{
+			auto c = Cross(a);
+			float len = std::sqrt(c.Dot(c));
+			return len > 0 ? c * (1 / len) : Vec(0, 0, 0);
+		}
+	};
+
+	struct Plane
+	{
+		Vec startPos, right_dir, up_dir;
+
+		Plane(const Vec& startPos, const Vec& cast_dir) : startPos(startPos)
+		{
+			right_dir = Vec(0, 0, -1).UnitCross(cast_dir);
+			if (right_dir.Dot(right_dir) == 0)
+				right_dir = { 1, 0, 0 };
+			up_dir = right_dir.Cross(cast_dir);
+		}
+	};
+
+	// The per-point formulas as they were, one call per point
+	struct Reference
+	{
+		Shape shape;
+		uint32_t count;
+		float size;
+		float rotate_alpha;
+
+		Vec Line(const Plane& plane, size_t ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			auto from = plane.startPos - plane.right_dir * (size * 0.5f);
+			float d = size / (count - 1);
+			return from + (plane.right_dir * (d * ind));
+		}
+		Vec Circle(const Plane& plane, size_t ind) const
+		{
+			float alpha = 2 * 3.1415926f / count * ind;
+			return plane.startPos + (plane.right_dir * cos(alpha) + plane.up_dir * sin(alpha)) * size;
+		}
+		Vec HalfCircle(const Plane& plane, size_t ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			float alpha = 3.1415926f / (count - 1) * ind;
+			return plane.startPos + (plane.right_dir * cos(alpha) + plane.up_dir * sin(alpha)) * size;
+		}
+		Vec FillSquare(const Plane& plane, size_t _ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			uint32_t m = static_cast<uint32_t>(sqrt(count));
+			uint32_t rest = count - m * m;
+			bool has_right = rest >= m;
+			bool has_up = rest != 0 && rest != m;
+
+			uint32_t w = has_right ? m + 1 : m;
+			uint32_t h = has_up ? m + 1 : m;
+
+			float dx = size / (w - 1);
+			float dy = h == 1 ? 0 : size / (h - 1);
+
+			uint32_t ind = _ind % count;
+
+			if (ind < w * m) {
+				uint32_t x = ind % w;
+				uint32_t y = ind / w;
+
+				auto from = plane.startPos - (plane.right_dir + plane.up_dir) * (size * 0.5f);
+				return from + plane.right_dir * (dx * x) + plane.up_dir * (dy * y);
+			} else {
+				ind -= w * m;
+				uint32_t up_size = rest >= m ? rest - m : rest;
+
+				uint32_t x = ind;
+				auto from = plane.startPos - plane.right_dir * ((up_size - 1) * 0.5f * dx) -
+				            plane.up_dir * (size * 0.5f - dy * m);
+				return from + plane.right_dir * (dx * x);
+			}
+		}
+		Vec FillCircle(const Plane& plane, size_t ind) const
+		{
+			float c = size / sqrtf(static_cast<float>(count));
+			auto alpha = 2.3999632297286533222f * ind;
+			float r = c * sqrtf(static_cast<float>(ind));
+
+			return plane.startPos + (plane.right_dir * cos(alpha) + plane.up_dir * sin(alpha)) * r;
+		}
+		Vec FillHalfCircle(const Plane& plane, size_t ind) const
+		{
+			float c = size / sqrtf(static_cast<float>(count));
+			float alpha = 0.5f * 2.3999632297286533222f * ind;
+			const float pi = 3.141592653589793f;
+			while (alpha >= 2 * pi)
+				alpha -= 2 * pi;
+			if (alpha >= pi)
+				alpha = alpha - pi;
+			float r = c * sqrtf(static_cast<float>(ind));
+			return plane.startPos + (plane.right_dir * cos(alpha) + plane.up_dir * sin(alpha)) * r;
+		}
+		Vec Sphere(const Plane& plane, size_t ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			float c = size;
+			float phi = 3.883222077450933f;
+			float y = 1 - (ind / (count - 1.0f)) * 2;
+			float radius = sqrt(1 - y * y);
+			float theta = phi * ind;
+			float x = cos(theta) * radius;
+			float z = sin(theta) * radius;
+
+			auto forward_dir = plane.up_dir.UnitCross(plane.right_dir);
+
+			return plane.startPos + (plane.right_dir * x + plane.up_dir * z + forward_dir * y) * c;
+		}
+		Vec HalfSphere(const Plane& plane, size_t ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			float c = size;
+			float phi = 3.883222077450933f;
+			float z = 1 - (ind / (count - 1.0f));
+			float radius = sqrt(1 - z * z);
+			float theta = phi * ind;
+			float x = cos(theta) * radius;
+			float y = sin(theta) * radius;
+
+			auto forward_dir = plane.up_dir.UnitCross(plane.right_dir);
+
+			return plane.startPos + (plane.right_dir * x + plane.up_dir * z + forward_dir * y) * c;
+		}
+		Vec Cylinder(const Plane& plane, size_t ind) const
+		{
+			if (count == 1)
+				return plane.startPos;
+
+			float c = size;
+			float phi = 3.883222077450933f;
+			float y = 1 - (ind / (count - 1.0f)) * 2;
+			float theta = phi * ind;
+			float x = cos(theta);
+			float z = sin(theta);
+
+			auto forward_dir = plane.up_dir.UnitCross(plane.right_dir);
+
+			return plane.startPos + (plane.right_dir * x + plane.up_dir * z + forward_dir * y) * c;
+		}
+
+		Vec get(const Plane& plane, size_t ind) const
+		{
+			switch (shape) {
+			case Shape::Line:
+				return Line(plane, ind);
+			case Shape::Circle:
+				return Circle(plane, ind);
+			case Shape::HalfCircle:
+				return HalfCircle(plane, ind);
+			case Shape::FillSquare:
+				return FillSquare(plane, ind);
+			case Shape::FillCircle:
+				return FillCircle(plane, ind);
+			case Shape::FillHalfCircle:
+				return FillHalfCircle(plane, ind);
+			case Shape::Sphere:
+				return Sphere(plane, ind);
+			case Shape::HalfSphere:
+				return HalfSphere(plane, ind);
+			case Shape::Cylinder:
+				return Cylinder(plane, ind);
+			default:
+				return plane.startPos;
+			}
+		}
+
+		// rotateFigure: Geom::rotate around the cast direction through the start
+		Vec rotate(const Vec& P, const Vec& O, const Vec& axis) const
+		{
+			if (rotate_alpha == 0.0f)
+				return P;
+
+			float c = cos(rotate_alpha);
+			float s = sin(rotate_alpha);
+			auto v = P - O;
+			return O + v * c + axis.Cross(v) * s + axis * (axis.Dot(v) * (1 - c));
+		}
+
+		void GetPositions(const Vec& start_pos, const Vec& cast_dir, std::vector<Vec>& out) const
+		{
+			out.clear();
+			Plane plane(start_pos, cast_dir);
+			for (size_t i = 0; i < count; i++) {
+				out.push_back(rotate(get(plane, i), plane.startPos, cast_dir));
+			}
+		}
+	};
+
+	// Local points placed in the plane, as Pattern::GetPositions does it
+	void place(const Points& local, const Plane& plane, Points& out)
+	{
+		using namespace SIMD;
+		out.resize(local.size());
+		auto S = broadcast(plane.startPos);
+		auto R = broadcast(plane.right_dir);
+		auto U = broadcast(plane.up_dir);
+		auto F = broadcast(plane.up_dir.UnitCross(plane.right_dir));
+		for (size_t i = 0; i < out.x.size(); i += WIDTH) {
+			auto L = load(&local.x[i], &local.y[i], &local.z[i]);
+			store(add(S, add(add(mul(R, L.x), mul(U, L.y)), mul(F, L.z))), &out.x[i], &out.y[i], &out.z[i]);
+		}
+	}
+
+	void get_soa(const Reference& figure, const Vec& start_pos, const Vec& cast_dir, Points& local, Points& out)
+	{
+		local.resize(figure.count);
+		get_local(figure.shape, figure.count, figure.size, local);
+		rotate_local(local, figure.rotate_alpha);
+		place(local, Plane(start_pos, cast_dir), out);
+	}
+
+	const Shape shapes[] = { Shape::Single, Shape::Line, Shape::Circle, Shape::HalfCircle, Shape::FillSquare,
+		Shape::FillCircle, Shape::FillHalfCircle, Shape::Sphere, Shape::HalfSphere, Shape::Cylinder };
+
+	const char* names[] = { "Single", "Line", "Circle", "HalfCircle", "FillSquare", "FillCircle", "FillHalfCircle",
+		"Sphere", "HalfSphere", "Cylinder" };
+
+	double distance(const Vec& a, const Vec& b)
+	{
+		auto d = a - b;
+		return std::sqrt(d.Dot(d));
+	}
+
+	Vec unit(const Vec& a) { return a * (1 / std::sqrt(a.Dot(a))); }
+
+	// Casts far from the world origin, a straight up one has no right direction from the formula
+	const Vec start_pos(1000.0f, -2000.0f, 300.0f);
+	const Vec cast_dirs[] = { unit({ 0.6f, 0.8f, 0.0f }), unit({ -0.3f, 0.2f, 0.9f }), unit({ 0.1f, -0.7f, -0.4f }),
+		{ 0.0f, 0.0f, 1.0f } };
+
+	// Old formulas take float angles of up to thousands of radians, at 1000 points they are off by up to 2e-3
+	void test_golden()
+	{
+		constexpr float SIZE = 150.0f;
+
+		double max_err = 0;
+		int flipped = 0;
+		Points local, out;
+		std::vector<Vec> expected;
+		for (size_t s = 0; s < std::size(shapes); s++) {
+			for (uint32_t count : { 1, 2, 7, 1000 }) {
+				for (float alpha : { 0.0f, 0.7f, -2.5f }) {
+					for (const auto& cast_dir : cast_dirs) {
+						Reference figure{ shapes[s], count, SIZE, alpha };
+						figure.GetPositions(start_pos, cast_dir, expected);
+						get_soa(figure, start_pos, cast_dir, local, out);
+
+						CHECK(out.size() == count);
+						const double TOL = count < 1000 ? 1e-2 : SIZE * 2e-3;
+						double err = 0;
+						for (size_t i = 0; i < count && i < out.size(); i++) {
+							Vec P(out.x[i], out.y[i], out.z[i]);
+							double cur = distance(P, expected[i]);
+
+							// FillHalfCircle angles taken modulo pi in floats: a point at the very edge of the half
+							// may be on the other end of its diameter
+							if (cur > TOL && shapes[s] == Shape::FillHalfCircle &&
+								distance(P, start_pos * 2 - expected[i]) <= TOL) {
+								flipped++;
+								continue;
+							}
+							err = std::max(err, cur);
+						}
+						if (err > TOL)
+							std::printf("%s of %u, alpha %g: error %g\n", names[s], count, alpha, err);
+						CHECK(err <= TOL);
+						max_err = std::max(max_err, err);
+					}
+				}
+			}
+		}
+		CHECK(flipped <= 12);
+		std::printf("golden max error: %g, %d FillHalfCircle points flipped\n", max_err, flipped);
+	}
+
+	template <typename F>
+	double time_ns(F&& f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// A whole figure per cast: placing a table baked at json load, generating the figure in SoA every cast,
+	// and the per-point formulas
+	void run(uint32_t count)
+	{
+		const int repeats = count >= 100 ? 200 : 20000;
+		double sum = 0;
+		Points local, out;
+		std::vector<Vec> expected;
+		for (size_t s = 0; s < std::size(shapes); s++) {
+			Reference figure{ shapes[s], count, 150.0f, 0.7f };
+			const auto& cast_dir = cast_dirs[1];
+
+			Points table;
+			table.resize(count);
+			get_local(figure.shape, count, figure.size, table);
+			rotate_local(table, figure.rotate_alpha);
+
+			double baked_ns = time_ns([&] {
+				for (int r = 0; r < repeats; r++) {
+					place(table, Plane(start_pos, cast_dir), out);
+					sum += out.x[count - 1];
+				}
+			});
+			double soa_ns = time_ns([&] {
+				for (int r = 0; r < repeats; r++) {
+					get_soa(figure, start_pos, cast_dir, local, out);
+					sum += out.x[count - 1];
+				}
+			});
+			double point_ns = time_ns([&] {
+				for (int r = 0; r < repeats; r++) {
+					figure.GetPositions(start_pos, cast_dir, expected);
+					sum += expected.back().x;
+				}
+			});
+
+			const double k = 1.0 / repeats / count;
+			std::printf("%-14s %4u points, per point: baked %5.1f ns, soa %5.1f ns, per-point %5.1f ns (%g)\n", names[s],
+				count, baked_ns * k, soa_ns * k, point_ns * k, sum);
+		}
+	}
+}
+
+int main()
+{
+	test_golden();
+	for (uint32_t count : { 7, 64, 1000 }) {
+		run(count);
+	}
+	return check_result();
+}
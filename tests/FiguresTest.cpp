@@ -0,0 +1,156 @@
+#include "Check.h"
+#include "Figures.h"
+
+#include <initializer_list>
+
+using namespace Figures;
+
+// Composite patterns against the same figures spawned as separate groups, one child group at every parent point
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Figure
+	{
+		Shape shape;
+		uint32_t count;
+		float size;
+		float alpha;  // planeRotate, radians
+	};
+
+	// Basis of the plane, same as Positioning::Pattern::GetPositions does it
+	struct Frame
+	{
+		Vec start, right, up, forward;
+
+		void place(const Points& local, Points& out) const
+		{
+			using namespace SIMD;
+			out.resize(local.size());
+			auto S = broadcast(start);
+			auto R = broadcast(right);
+			auto U = broadcast(up);
+			auto F = broadcast(forward);
+			for (size_t i = 0; i < out.x.size(); i += WIDTH) {
+				auto L = load(&local.x[i], &local.y[i], &local.z[i]);
+				store(add(S, add(add(mul(R, L.x), mul(U, L.y)), mul(F, L.z))), &out.x[i], &out.y[i], &out.z[i]);
+			}
+		}
+
+		Vec at(const Points& local, size_t i) const
+		{
+			float x = local.x[i], y = local.y[i], z = local.z[i];
+			return { start.x + right.x * x + up.x * y + forward.x * z, start.y + right.y * x + up.y * y + forward.y * z,
+				start.z + right.z * x + up.z * y + forward.z * z };
+		}
+	};
+
+	Points get_baked(const Figure& figure)
+	{
+		Points ans;
+		ans.resize(figure.count);
+		get_local(figure.shape, figure.count, figure.size, ans);
+		rotate_local(ans, figure.alpha);
+		return ans;
+	}
+
+	// A figure with children down to the last one, the way Pattern::initChild builds the table
+	Points get_composite(std::initializer_list<Figure> figures)
+	{
+		auto it = std::rbegin(figures);
+		Points ans = get_baked(*it);
+		for (++it; it != std::rend(figures); ++it) {
+			Points parent = get_baked(*it);
+			Points composed;
+			compose(parent, ans, composed);
+			ans = std::move(composed);
+		}
+		return ans;
+	}
+
+	// Groups spawned at the points of `parent` in the same plane, each with the `child` pattern
+	Points get_groups(const Frame& frame, const Points& parent, const Points& child)
+	{
+		Points ans;
+		ans.resize(parent.size() * child.size());
+		for (size_t i = 0; i < parent.size(); i++) {
+			Frame group = frame;
+			group.start = frame.at(parent, i);
+
+			Points points;
+			group.place(child, points);
+			for (size_t j = 0; j < child.size(); j++) {
+				ans.x[i * child.size() + j] = points.x[j];
+				ans.y[i * child.size() + j] = points.y[j];
+				ans.z[i * child.size() + j] = points.z[j];
+			}
+		}
+		return ans;
+	}
+
+	void check_same(const Points& a, const Points& b)
+	{
+		CHECK(a.size() == b.size());
+		for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+			CHECK_NEAR(a.x[i], b.x[i], 1e-2);
+			CHECK_NEAR(a.y[i], b.y[i], 1e-2);
+			CHECK_NEAR(a.z[i], b.z[i], 1e-2);
+		}
+	}
+
+	// Left-handed (right, up, forward) of a tilted cast, far from the world origin
+	const Frame frame{ { 1000.0f, -2000.0f, 300.0f }, { 0.8f, -0.6f, 0.0f }, { 0.36f, 0.48f, 0.8f }, { 0.48f, 0.64f, -0.6f } };
+
+	void test_composite(const Figure& parent, const Figure& child)
+	{
+		Points composite;
+		frame.place(get_composite({ parent, child }), composite);
+		check_same(composite, get_groups(frame, get_baked(parent), get_baked(child)));
+	}
+
+	void test_nested()
+	{
+		Figure a{ Shape::Circle, 5, 300.0f, 0.3f };
+		Figure b{ Shape::Line, 3, 60.0f, 1.0f };
+		Figure c{ Shape::Sphere, 7, 10.0f, 0.0f };
+
+		Points composite;
+		frame.place(get_composite({ a, b, c }), composite);
+		check_same(composite, get_groups(frame, get_baked(a), get_composite({ b, c })));
+	}
+
+	void test_figures()
+	{
+		// Circle points are on the circle, padding stays zero
+		auto circle = get_baked({ Shape::Circle, 7, 50.0f, 0.4f });
+		CHECK(circle.x.size() == 8);
+		for (size_t i = 0; i < circle.size(); i++) {
+			CHECK_NEAR(std::sqrt(circle.x[i] * circle.x[i] + circle.y[i] * circle.y[i]), 50.0, 1e-3);
+			CHECK(circle.z[i] == 0.0f);
+		}
+		CHECK(circle.x[7] == 0.0f && circle.y[7] == 0.0f && circle.z[7] == 0.0f);
+
+		// Rotation by planeRotate turns the first point towards -up, the basis is left-handed
+		auto line = get_baked({ Shape::Line, 2, 20.0f, 3.14159265f / 2 });
+		CHECK_NEAR(line.x[1], 0.0, 1e-4);
+		CHECK_NEAR(line.y[1], -10.0, 1e-4);
+
+		// A single point is the start
+		auto single = get_baked({ Shape::Single, 1, 0.0f, 0.7f });
+		CHECK(single.x[0] == 0.0f && single.y[0] == 0.0f && single.z[0] == 0.0f);
+	}
+}
+
+int main()
+{
+	test_composite({ Shape::Circle, 8, 200.0f, 0.5f }, { Shape::Line, 3, 40.0f, 0.8f });
+	test_composite({ Shape::Sphere, 10, 150.0f, 0.0f }, { Shape::FillSquare, 5, 30.0f, -0.2f });
+	test_composite({ Shape::FillCircle, 13, 100.0f, 1.3f }, { Shape::HalfSphere, 6, 15.0f, 0.0f });
+	test_composite({ Shape::Single, 1, 0.0f, 0.0f }, { Shape::Cylinder, 9, 25.0f, 2.0f });
+	test_nested();
+	test_figures();
+	return check_result();
+}
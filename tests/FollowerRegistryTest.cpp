@@ -0,0 +1,214 @@
+#include "Check.h"
+#include "FollowerRegistry.h"
+
+#include <memory>
+
+// Registry of followers against fake projectiles, handles and a fake projectile manager
+namespace
+{
+	struct Proj
+	{
+		uint32_t formID;
+		uint32_t caster;  // 0 for a projectile that is not a follower
+	};
+
+	struct Ptr
+	{
+		Proj* proj;
+
+		Proj* get() const { return proj; }
+		explicit operator bool() const { return proj; }
+	};
+
+	// Empty once the projectile is gone, as RE::ProjectileHandle
+	struct Handle
+	{
+		std::shared_ptr<Proj*> slot;
+
+		Ptr get() const { return { slot ? *slot : nullptr }; }
+	};
+
+	struct Manager
+	{
+		std::vector<Handle> limited, pending, unlimited;
+	};
+
+	// Projectiles of the game, formIDs may be reused
+	struct World
+	{
+		std::vector<std::unique_ptr<Proj>> all;
+		std::vector<Handle> handles;
+
+		std::pair<Proj*, Handle> spawn(uint32_t formID, uint32_t caster = 0)
+		{
+			all.push_back(std::make_unique<Proj>(Proj{ formID, caster }));
+			handles.push_back({ std::make_shared<Proj*>(all.back().get()) });
+			return { all.back().get(), handles.back() };
+		}
+
+		void kill(const Handle& handle) { *handle.slot = nullptr; }
+	};
+
+	using Registry = FollowerRegistry<Proj, Handle>;
+
+	std::vector<uint32_t> ids(const std::vector<Handle>& handles)
+	{
+		std::vector<uint32_t> ans;
+		for (const auto& handle : handles) {
+			ans.push_back(handle.get() ? handle.get().get()->formID : 0);
+		}
+		return ans;
+	}
+
+	using Ids = std::vector<uint32_t>;
+
+	void test_add_remove()
+	{
+		World world;
+		Registry registry;
+		auto [a, ha] = world.spawn(1);
+		auto [b, hb] = world.spawn(2);
+		auto [c, hc] = world.spawn(3);
+		auto [d, hd] = world.spawn(4);
+
+		CHECK(registry.add(a, 100, ha) == Registry::Added::New);
+		CHECK(registry.add(b, 100, hb) == Registry::Added::New);
+		CHECK(registry.add(c, 100, hc) == Registry::Added::New);
+		CHECK(registry.add(d, 200, hd) == Registry::Added::New);
+		CHECK(registry.add(b, 100, hb) == Registry::Added::Again);
+		CHECK(ids(registry.get(100)) == Ids({ 1, 2, 3 }));
+		CHECK(ids(registry.get(200)) == Ids({ 4 }));
+		CHECK(registry.get(300).empty());
+
+		// The order of applying is kept
+		registry.remove(b);
+		CHECK(!registry.has(b) && registry.has(a) && registry.has(c));
+		CHECK(ids(registry.get(100)) == Ids({ 1, 3 }));
+		registry.remove(b);
+		CHECK(registry.size() == 3);
+
+		registry.remove(d);
+		CHECK(registry.get(200).empty());
+		CHECK(registry.size() == 2);
+
+		registry.clear();
+		CHECK(!registry.has(a) && registry.get(100).empty() && registry.size() == 0);
+	}
+
+	// A new projectile with the formID of a gone one replaces it, the old pointer matches nothing
+	void test_reuse()
+	{
+		World world;
+		Registry registry;
+		auto [old, hold] = world.spawn(0x10);
+		auto [other, hother] = world.spawn(0x11);
+		registry.add(old, 100, hold);
+		registry.add(other, 100, hother);
+
+		world.kill(hold);
+		auto [cur, hcur] = world.spawn(0x10);
+		CHECK(registry.add(cur, 200, hcur) == Registry::Added::Replaced);
+		CHECK(registry.has(cur) && !registry.has(old));
+		CHECK(ids(registry.get(100)) == Ids({ 0x11 }));
+		CHECK(ids(registry.get(200)) == Ids({ 0x10 }));
+		CHECK(registry.size() == 2);
+
+		// Removing the stale one does not touch the new one
+		registry.remove(old);
+		CHECK(registry.has(cur));
+		CHECK(ids(registry.get(200)) == Ids({ 0x10 }));
+
+		// Same caster, the new one goes last
+		auto [again, hagain] = world.spawn(0x11);
+		CHECK(registry.add(again, 100, hagain) == Registry::Added::Replaced);
+		auto [next, hnext] = world.spawn(0x12);
+		registry.add(next, 100, hnext);
+		CHECK(ids(registry.get(100)) == Ids({ 0x11, 0x12 }));
+		CHECK(!registry.has(other) && registry.has(again));
+
+		registry.remove(cur);
+		CHECK(!registry.has(cur) && registry.get(200).empty());
+	}
+
+	// Followers gone without being removed are dropped on the next get of their caster
+	void test_lazy_drop()
+	{
+		World world;
+		Registry registry;
+		std::vector<std::pair<Proj*, Handle>> all;
+		for (uint32_t i = 1; i <= 5; i++) {
+			all.push_back(world.spawn(i));
+			registry.add(all.back().first, 100, all.back().second);
+		}
+
+		world.kill(all[1].second);
+		world.kill(all[3].second);
+		CHECK(registry.has(all[1].first) && registry.size() == 5);  // nothing is dropped before get
+
+		CHECK(ids(registry.get(100)) == Ids({ 1, 3, 5 }));
+		CHECK(!registry.has(all[1].first) && !registry.has(all[3].first));
+		CHECK(registry.size() == 3);
+
+		for (auto& [proj, handle] : all) {
+			world.kill(handle);
+		}
+		CHECK(registry.get(100).empty());
+		CHECK(registry.size() == 0);
+
+		// A formID of a dropped follower is free to register again
+		auto [cur, hcur] = world.spawn(2);
+		CHECK(registry.add(cur, 100, hcur) == Registry::Added::New);
+	}
+
+	// Registered again from the manager: followers only, in the order of the lists, stale entries are forgotten
+	void test_rebuild()
+	{
+		World world;
+		Registry registry;
+		Manager manager;
+
+		auto [stale, hstale] = world.spawn(0x20, 100);
+		registry.add(stale, 100, hstale);
+		world.kill(hstale);
+		auto [moved, hmoved] = world.spawn(0x21, 300);
+		registry.add(moved, 100, hmoved);  // its caster is different now
+
+		auto put = [&](std::vector<Handle>& list, uint32_t formID, uint32_t caster) {
+			auto [proj, handle] = world.spawn(formID, caster);
+			list.push_back(handle);
+			return proj;
+		};
+		auto f1 = put(manager.limited, 0x01, 100);
+		put(manager.limited, 0x02, 0);
+		auto f3 = put(manager.pending, 0x03, 200);
+		auto f4 = put(manager.unlimited, 0x04, 100);
+		put(manager.unlimited, 0x05, 100);
+		world.kill(manager.unlimited.back());
+		manager.unlimited.push_back(hmoved);
+		manager.pending.push_back(manager.limited.front());  // listed twice
+
+		auto live = registry.rebuild(manager, [](Proj* proj, uint32_t& caster) {
+			caster = proj->caster;
+			return caster != 0;
+		});
+		CHECK(live == std::vector<Proj*>({ f1, f3, f4, moved }));
+		CHECK(ids(registry.get(100)) == Ids({ 0x01, 0x04 }));
+		CHECK(ids(registry.get(200)) == Ids({ 0x03 }));
+		CHECK(ids(registry.get(300)) == Ids({ 0x21 }));
+		CHECK(!registry.has(stale));
+		CHECK(registry.size() == 4);
+
+		// An empty manager leaves nothing
+		CHECK(registry.rebuild(Manager{}, [](Proj*, uint32_t&) { return true; }).empty());
+		CHECK(registry.size() == 0 && registry.get(100).empty());
+	}
+}
+
+int main()
+{
+	test_add_remove();
+	test_reuse();
+	test_lazy_drop();
+	test_rebuild();
+	return check_result();
+}
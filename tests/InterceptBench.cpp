@@ -0,0 +1,155 @@
+#include "Check.h"
+#include "Intercept.h"
+
+#include <chrono>
+#include <random>
+
+// Homing projectiles over many frames: batched intercepts against the scalar solve, checked and timed
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Homing
+	{
+		Vec pos, vel;
+		Vec target_pos, target_vel;
+		float speed;
+	};
+
+	std::vector<Homing> random_projectiles(std::mt19937& rng, size_t n)
+	{
+		std::uniform_real_distribution<float> coord(-10000.0f, 10000.0f);
+		std::uniform_real_distribution<float> offset(-3000.0f, 3000.0f);
+		std::uniform_real_distribution<float> vel(-400.0f, 400.0f);
+		std::uniform_real_distribution<float> speed(500.0f, 3000.0f);
+
+		std::vector<Homing> ans;
+		for (size_t i = 0; i < n; i++) {
+			Homing h;
+			h.pos = { coord(rng), coord(rng), coord(rng) / 10 };
+			h.target_pos = { h.pos.x + offset(rng), h.pos.y + offset(rng), h.pos.z + offset(rng) / 10 };
+			h.target_vel = { vel(rng), vel(rng), 0 };
+			h.speed = speed(rng);
+			h.vel = { h.speed, 0, 0 };
+			ans.push_back(h);
+		}
+		return ans;
+	}
+
+	// Projectiles fly along their intercepts, targets go straight
+	void advance(std::vector<Homing>& all, float dtime)
+	{
+		for (auto& h : all) {
+			h.pos = { h.pos.x + h.vel.x * dtime, h.pos.y + h.vel.y * dtime, h.pos.z + h.vel.z * dtime };
+			h.target_pos = { h.target_pos.x + h.target_vel.x * dtime, h.target_pos.y + h.target_vel.y * dtime,
+				h.target_pos.z + h.target_vel.z * dtime };
+		}
+	}
+
+	// Gathering, as Homing does it every frame
+	void fill(Intercept::Buffers& soa, const std::vector<Homing>& all)
+	{
+		soa.resize(all.size());
+		for (size_t i = 0; i < all.size(); i++) {
+			const auto& h = all[i];
+			soa.px[i] = h.pos.x;
+			soa.py[i] = h.pos.y;
+			soa.pz[i] = h.pos.z;
+			soa.tx[i] = h.target_pos.x;
+			soa.ty[i] = h.target_pos.y;
+			soa.tz[i] = h.target_pos.z;
+			soa.vx[i] = h.target_vel.x;
+			soa.vy[i] = h.target_vel.y;
+			soa.vz[i] = h.target_vel.z;
+			soa.speed[i] = h.speed;
+			soa.state[i] = Intercept::State::Ok;
+		}
+	}
+
+	// Results go back to projectiles, Scalar lanes take the usual path
+	size_t apply(const Intercept::Buffers& soa, std::vector<Homing>& all)
+	{
+		size_t scalar = 0;
+		for (size_t i = 0; i < all.size(); i++) {
+			auto& h = all[i];
+			switch (soa.state[i]) {
+			case Intercept::State::Ok:
+				h.vel = { soa.fx[i], soa.fy[i], soa.fz[i] };
+				break;
+			case Intercept::State::Scalar:
+				scalar++;
+				Intercept::solve(h.pos, h.speed, h.target_pos, h.target_vel, h.vel);
+				break;
+			default:
+				break;
+			}
+		}
+		return scalar;
+	}
+
+	void apply_scalar(std::vector<Homing>& all)
+	{
+		for (auto& h : all) {
+			Intercept::solve(h.pos, h.speed, h.target_pos, h.target_vel, h.vel);
+		}
+	}
+
+	template <typename F>
+	double time_ns(F&& f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void run(size_t n, int frames)
+	{
+		constexpr float DTIME = 1.0f / 60;
+
+		std::mt19937 rng(static_cast<uint32_t>(n));
+		const auto start = random_projectiles(rng, n);
+
+		// Both runs fly the same frames, the velocities stay close to each other
+		auto batched = start;
+		auto scalar = start;
+		Intercept::Buffers soa;
+		size_t scalar_lanes = 0;
+		double batch_ns = 0, solve_ns = 0, scalar_ns = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			batch_ns += time_ns([&] {
+				fill(soa, batched);
+				solve_ns += time_ns([&] { Intercept::solve(soa); });
+				scalar_lanes += apply(soa, batched);
+			});
+			scalar_ns += time_ns([&] { apply_scalar(scalar); });
+
+			advance(batched, DTIME);
+			advance(scalar, DTIME);
+		}
+
+		// Targets are reached within about a second, positions are compared before that
+		double max_err = 0;
+		for (size_t i = 0; i < n; i++) {
+			max_err = std::max(max_err, double(std::abs(batched[i].pos.x - scalar[i].pos.x)));
+			max_err = std::max(max_err, double(std::abs(batched[i].pos.y - scalar[i].pos.y)));
+			max_err = std::max(max_err, double(std::abs(batched[i].pos.z - scalar[i].pos.z)));
+		}
+		CHECK(max_err < 1.0);
+
+		const double k = 1.0 / frames / n;
+		std::printf("%5zu projectiles, %d frames, per projectile: batch %5.1f ns (solve %5.1f ns), scalar %5.1f ns, "
+		            "max drift %g, %zu scalar lanes\n",
+			n, frames, batch_ns * k, solve_ns * k, scalar_ns * k, max_err, scalar_lanes);
+	}
+}
+
+int main()
+{
+	run(100, 30);
+	run(1000, 30);
+	run(10000, 30);
+	return check_result();
+}
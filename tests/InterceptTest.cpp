@@ -0,0 +1,167 @@
+#include "Check.h"
+#include "Intercept.h"
+
+#include <random>
+
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Scene
+	{
+		Vec pos, target_pos, target_vel;
+		float speed;
+	};
+
+	Scene random_scene(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> vel(-400.0f, 400.0f);
+		std::uniform_real_distribution<float> speed(500.0f, 3000.0f);
+		return { { coord(rng), coord(rng), coord(rng) }, { coord(rng), coord(rng), coord(rng) },
+			{ vel(rng), vel(rng), vel(rng) }, speed(rng) };
+	}
+
+	void fill(Intercept::Buffers& soa, size_t i, const Scene& scene)
+	{
+		soa.px[i] = scene.pos.x;
+		soa.py[i] = scene.pos.y;
+		soa.pz[i] = scene.pos.z;
+		soa.tx[i] = scene.target_pos.x;
+		soa.ty[i] = scene.target_pos.y;
+		soa.tz[i] = scene.target_pos.z;
+		soa.vx[i] = scene.target_vel.x;
+		soa.vy[i] = scene.target_vel.y;
+		soa.vz[i] = scene.target_vel.z;
+		soa.speed[i] = scene.speed;
+		soa.state[i] = Intercept::State::Ok;
+	}
+
+	// Batched lanes give the scalar answer, and unreachable targets are rejected by both
+	void test_lanes()
+	{
+		std::mt19937 rng(1);
+		constexpr size_t N = 1001;  // not a multiple of the width
+
+		std::vector<Scene> scenes(N);
+		Intercept::Buffers soa;
+		soa.resize(N);
+		for (size_t i = 0; i < N; i++) {
+			scenes[i] = random_scene(rng);
+			if (i % 10 == 0)
+				scenes[i].speed = 100.0f;  // slower than the target, often unreachable
+			fill(soa, i, scenes[i]);
+		}
+		Intercept::solve(soa);
+
+		for (size_t i = 0; i < N; i++) {
+			const auto& scene = scenes[i];
+			Vec ans;
+			bool ok = Intercept::solve(scene.pos, scene.speed, scene.target_pos, scene.target_vel, ans);
+			CHECK(soa.state[i] != Intercept::State::Scalar);
+			CHECK(ok == (soa.state[i] == Intercept::State::Ok));
+			if (ok && soa.state[i] == Intercept::State::Ok) {
+				float eps = 1e-3f * scene.speed;
+				CHECK_NEAR(soa.fx[i], ans.x, eps);
+				CHECK_NEAR(soa.fy[i], ans.y, eps);
+				CHECK_NEAR(soa.fz[i], ans.z, eps);
+			}
+		}
+
+		// Padding lanes stay untouched
+		CHECK(soa.state[N] == Intercept::State::Scalar);
+	}
+
+	void test_degenerate()
+	{
+		Intercept::Buffers soa;
+		soa.resize(2);
+		Scene same_pos{ { 1, 2, 3 }, { 1, 2, 3 }, { 0, 0, 0 }, 1000 };
+		Scene same_speed{ { 0, 0, 0 }, { 1000, 0, 0 }, { 0, 1000, 0 }, 1000 };
+		fill(soa, 0, same_pos);
+		fill(soa, 1, same_speed);
+		Intercept::solve(soa);
+		CHECK(soa.state[0] == Intercept::State::Scalar);
+		CHECK(soa.state[1] == Intercept::State::Scalar);
+	}
+
+	float dist(const Vec& a, const Vec& b)
+	{
+		float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+		return std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
+	// Projectiles fly toward the intercept point every frame until they hit.
+	// Trajectories of the batched and the scalar path stay close
+	void test_trajectory()
+	{
+		constexpr size_t N = 64;
+		constexpr int FRAMES = 300;
+		constexpr float DTIME = 1.0f / 60.0f;
+
+		std::mt19937 rng(2);
+		std::vector<Scene> scalar(N), batched(N);
+		for (size_t i = 0; i < N; i++) {
+			scalar[i] = batched[i] = random_scene(rng);
+		}
+
+		auto step = [](Scene& scene, const Vec& vel) {
+			scene.pos = { scene.pos.x + vel.x * DTIME, scene.pos.y + vel.y * DTIME, scene.pos.z + vel.z * DTIME };
+			const auto& v = scene.target_vel;
+			scene.target_pos = { scene.target_pos.x + v.x * DTIME, scene.target_pos.y + v.y * DTIME,
+				scene.target_pos.z + v.z * DTIME };
+		};
+
+		// A hit is closer than a frame of flight
+		auto hit = [](const Scene& scene) { return dist(scene.pos, scene.target_pos) < scene.speed * DTIME; };
+
+		Intercept::Buffers soa;
+		float max_dev = 0.0f;
+		for (int frame = 0; frame < FRAMES; frame++) {
+			soa.resize(N);
+			for (size_t i = 0; i < N; i++) {
+				fill(soa, i, batched[i]);
+			}
+			Intercept::solve(soa);
+
+			for (size_t i = 0; i < N; i++) {
+				if (hit(scalar[i]) || hit(batched[i]))
+					continue;
+
+				Vec vel{ 0, 0, 0 };
+				if (Intercept::solve(scalar[i].pos, scalar[i].speed, scalar[i].target_pos, scalar[i].target_vel, vel))
+					step(scalar[i], vel);
+				else
+					step(scalar[i], { 0, 0, 0 });
+
+				if (soa.state[i] == Intercept::State::Ok)
+					step(batched[i], { soa.fx[i], soa.fy[i], soa.fz[i] });
+				else
+					step(batched[i], { 0, 0, 0 });
+
+				max_dev = std::max(max_dev, dist(scalar[i].pos, batched[i].pos));
+			}
+		}
+
+		size_t hits = 0;
+		for (size_t i = 0; i < N; i++) {
+			CHECK(hit(scalar[i]) == hit(batched[i]));
+			hits += hit(scalar[i]);
+		}
+
+		std::printf("trajectory max deviation: %g, hits: %zu of %zu\n", max_dev, hits, N);
+		CHECK(max_dev < 1.0f);
+		CHECK(hits > 0);
+	}
+}
+
+int main()
+{
+	test_lanes();
+	test_degenerate();
+	test_trajectory();
+	return check_result();
+}
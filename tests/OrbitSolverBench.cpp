@@ -0,0 +1,196 @@
+#include "Check.h"
+#include "OrbitSolver.h"
+
+#include <chrono>
+#include <random>
+
+// Checks the batch against the scalar orbit steps and prints timings of both
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+
+		Vec() = default;
+		Vec(float x, float y, float z) : x(x), y(y), z(z) {}
+	};
+
+	struct Follower
+	{
+		Vec P, V, O, C;
+		float R;
+		bool sphere;
+	};
+
+	Vec random_dir(std::mt19937& rng)
+	{
+		std::normal_distribution<float> n;
+		Vec d(n(rng), n(rng), n(rng));
+		float len = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+		return { d.x / len, d.y / len, d.z / len };
+	}
+
+	// A follower on its orbit around a caster somewhere in the loaded area
+	Follower random_follower(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> area(-20000.0f, 20000.0f);
+		std::uniform_real_distribution<float> radius(50.0f, 300.0f);
+		std::uniform_real_distribution<float> k(OrbitSolver::CIRCLE_K_SML, OrbitSolver::CIRCLE_K_BIG);
+		std::uniform_real_distribution<float> height(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> speed(500.0f, 3000.0f);
+
+		Follower f;
+		f.sphere = rng() % 2;
+		f.O = { area(rng), area(rng), area(rng) / 10 };
+		f.C = random_dir(rng);
+		f.R = radius(rng);
+
+		// Offset from the center, in the plane of C for cylinders
+		auto d = random_dir(rng);
+		float r = f.R * k(rng);
+		if (!f.sphere) {
+			auto u = OrbitSolver::Scalar::UnitCross(d, f.C);
+			float h = height(rng);
+			d = { u.x * r + f.C.x * h, u.y * r + f.C.y * h, u.z * r + f.C.z * h };
+		} else {
+			d = { d.x * r, d.y * r, d.z * r };
+		}
+		f.P = { f.O.x + d.x, f.O.y + d.y, f.O.z + d.z };
+
+		auto v = random_dir(rng);
+		float s = speed(rng);
+		f.V = { v.x * s, v.y * s, v.z * s };
+		return f;
+	}
+
+	Vec step(const Follower& f, float dtime)
+	{
+		return f.sphere ? OrbitSolver::step_sphere(f.P, f.V, f.O, f.R, dtime) :
+		                  OrbitSolver::step_plane(f.P, f.V, f.O, f.C, f.R, dtime);
+	}
+
+	template <typename F>
+	double time_ns(F&& f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void test_sincos()
+	{
+		double max_err = 0;
+		for (float x = -100.0f; x <= 100.0f; x += 0.0123f) {
+			alignas(16) float s[4], c[4];
+			__m128 vs, vc;
+			SIMD::sincos(_mm_set_ps(x, -x, x * 0.5f, x * 0.01f), vs, vc);
+			_mm_store_ps(s, vs);
+			_mm_store_ps(c, vc);
+			const float in[4] = { x * 0.01f, x * 0.5f, -x, x };
+			for (int j = 0; j < 4; j++) {
+				max_err = std::max(max_err, std::abs(s[j] - std::sin(double(in[j]))));
+				max_err = std::max(max_err, std::abs(c[j] - std::cos(double(in[j]))));
+			}
+		}
+		CHECK(max_err < 1e-6);
+		std::printf("sincos max error: %g\n", max_err);
+	}
+
+	void test_on_orbit()
+	{
+		Vec O(0, 0, 0), C(0, 0, 1);
+		CHECK(OrbitSolver::on_orbit(Vec(100, 0, 0), O, C, 100.0f, true));
+		CHECK(!OrbitSolver::on_orbit(Vec(100, 0, 50), O, C, 100.0f, true));
+		CHECK(OrbitSolver::on_orbit(Vec(100, 0, 50), O, C, 100.0f, false));  // height along the axis is ignored
+		CHECK(!OrbitSolver::on_orbit(Vec(50, 0, 0), O, C, 100.0f, false));
+		CHECK(!OrbitSolver::on_orbit(Vec(0, 0, 0), O, C, 0.0f, true));
+	}
+
+	void run(size_t n)
+	{
+		constexpr float DTIME = 1.0f / 60;
+		constexpr int REPEATS = 200;
+
+		std::mt19937 rng(static_cast<uint32_t>(n));
+		std::vector<Follower> followers;
+		for (size_t i = 0; i < n; i++) {
+			followers.push_back(random_follower(rng));
+		}
+		// A stopped follower cannot move along its orbit
+		followers.push_back(random_follower(rng));
+		followers.back().V = { 0, 0, 0 };
+
+		OrbitSolver::Batch batch;
+		std::vector<uint32_t> lanes;
+		auto fill = [&]() {
+			batch.clear();
+			lanes.clear();
+			for (const auto& f : followers) {
+				lanes.push_back(batch.add(f.P, f.V, f.O, f.C, f.R, f.sphere));
+			}
+		};
+
+		for (const auto& f : followers) {
+			CHECK(OrbitSolver::on_orbit(f.P, f.O, f.C, f.R, f.sphere));
+		}
+
+		// Accuracy, positions are far from the origin so floats are good to about 1e-3 there
+		fill();
+		batch.solve(DTIME);
+		CHECK(batch.size() == followers.size());
+		double max_err = 0;
+		for (size_t i = 0; i < followers.size(); i++) {
+			Vec ans;
+			bool ok = batch.get(lanes[i], ans);
+			CHECK(ok == (i < n));
+			if (!ok)
+				continue;
+
+			auto expected = step(followers[i], DTIME);
+			max_err = std::max(max_err, double(std::abs(ans.x - expected.x)));
+			max_err = std::max(max_err, double(std::abs(ans.y - expected.y)));
+			max_err = std::max(max_err, double(std::abs(ans.z - expected.z)));
+		}
+		CHECK(max_err < 0.01);
+
+		// Timings, the batch is filled every frame too. `sum` keeps the loops alive
+		double sum = 0;
+		double batch_ns = time_ns([&] {
+			for (int r = 0; r < REPEATS; r++) {
+				fill();
+				batch.solve(DTIME);
+				Vec ans;
+				for (auto lane : lanes) {
+					if (batch.get(lane, ans))
+						sum += ans.x;
+				}
+			}
+		});
+		double solve_ns = time_ns([&] {
+			for (int r = 0; r < REPEATS; r++) {
+				batch.solve(DTIME);
+			}
+		});
+		double scalar_ns = time_ns([&] {
+			for (int r = 0; r < REPEATS; r++) {
+				for (const auto& f : followers) {
+					sum += step(f, DTIME).x;
+				}
+			}
+		});
+
+		const double k = 1.0 / REPEATS / followers.size();
+		std::printf("%5zu followers, per follower: batch %5.1f ns (solve %5.1f ns), scalar %5.1f ns, max error %g (%g)\n", n,
+			batch_ns * k, solve_ns * k, scalar_ns * k, max_err, sum);
+	}
+}
+
+int main()
+{
+	test_sincos();
+	test_on_orbit();
+	for (size_t n : { 1, 7, 100, 1000 }) {
+		run(n);
+	}
+	return check_result();
+}
@@ -0,0 +1,182 @@
+#include "Check.h"
+#include "PairCache.h"
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	void test_ttl()
+	{
+		PairCache<int> cache(2.0f, 10.0f);
+		int calls = 0;
+		auto compute = [&calls]() { return ++calls; };
+		bool hit;
+
+		CHECK(cache.get(1, 2, 0.0f, compute, hit) == 1 && !hit);
+		CHECK(cache.get(1, 2, 1.5f, compute, hit) == 1 && hit);
+		CHECK(cache.get(2, 1, 1.5f, compute, hit) == 2 && !hit);  // pairs are ordered
+		CHECK(cache.get(1, 2, 2.5f, compute, hit) == 3 && !hit);  // too old
+	}
+
+	void test_invalidate()
+	{
+		PairCache<int> cache(2.0f, 10.0f);
+		int calls = 0;
+		auto compute = [&calls]() { return ++calls; };
+		bool hit;
+
+		cache.get(1, 2, 0.0f, compute, hit);
+		cache.get(2, 1, 0.0f, compute, hit);
+		cache.get(1, 3, 0.0f, compute, hit);
+		cache.invalidate(2, 1);
+		CHECK(cache.size() == 1);
+		cache.get(1, 3, 0.0f, compute, hit);
+		CHECK(hit);
+		cache.get(1, 2, 0.0f, compute, hit);
+		CHECK(!hit);
+	}
+
+	void test_prune()
+	{
+		PairCache<int> cache(2.0f, 10.0f);
+		bool hit;
+		for (uint32_t i = 0; i < 100; i++) {
+			cache.get(i, 0, 10.0f, [] { return 0; }, hit);
+		}
+		cache.get(1000, 0, 11.0f, [] { return 0; }, hit);  // pruned, fresh ones are kept
+		CHECK(cache.size() == 101);
+		cache.get(1000, 0, 21.0f, [] { return 0; }, hit);  // pruned, only the asked one is back
+		CHECK(cache.size() == 1);
+	}
+
+	template <typename F>
+	double time_ns(F&& f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Stub of the hostility check, `cost` rounds of busy work per call. `sink` keeps the work alive
+	struct Oracle
+	{
+		int cost;
+		size_t calls = 0;
+		uint32_t sink = 0;
+
+		bool operator()(uint32_t target, uint32_t caster)
+		{
+			calls++;
+			uint32_t h = target * 2654435761u ^ caster;
+			for (int i = 0; i < cost; i++) {
+				h = h * 1664525u + 1013904223u;
+			}
+			sink += h;
+			return (target * 31 + caster) % 3 == 0;
+		}
+	};
+
+	// Every frame each caster scans all candidates, as target filtering does, with and without the cache
+	void bench_scan(uint32_t candidates, uint32_t casters, int cost)
+	{
+		constexpr int FRAMES = 120;
+		constexpr float DTIME = 1.0f / 60;
+
+		Oracle direct{ cost }, cached{ cost };
+		PairCache<bool> cache(2.0f, 10.0f);
+		size_t hostile = 0, hostile_cached = 0;
+		bool hit;
+
+		double direct_ns = time_ns([&] {
+			for (int f = 0; f < FRAMES; f++) {
+				for (uint32_t c = 0; c < casters; c++) {
+					for (uint32_t t = 0; t < candidates; t++) {
+						hostile += direct(t + 1000, c);
+					}
+				}
+			}
+		});
+		double cached_ns = time_ns([&] {
+			for (int f = 0; f < FRAMES; f++) {
+				float now = f * DTIME;
+				for (uint32_t c = 0; c < casters; c++) {
+					for (uint32_t t = 0; t < candidates; t++) {
+						hostile_cached += cache.get(t + 1000, c, now, [&] { return cached(t + 1000, c); }, hit);
+					}
+				}
+			}
+		});
+		CHECK(hostile == hostile_cached);
+
+		const double k = 1.0 / FRAMES / casters / candidates;
+		std::printf("%5u candidates x %2u casters, oracle cost %4d: direct %6.1f ns, cached %6.1f ns per check, "
+		            "%zu of %zu oracle calls (%u)\n",
+			candidates, casters, cost, direct_ns * k, cached_ns * k, cached.calls, direct.calls, direct.sink ^ cached.sink);
+	}
+
+	// Side note: cost of a cache hit against a pointer load, like reading currentCombatTarget of an actor
+	void bench_hit()
+	{
+		constexpr uint32_t ACTORS = 64;
+		constexpr uint32_t CASTERS = 4;
+		constexpr int LOOKUPS = 1 << 20;
+
+		struct Actor
+		{
+			char pad[0x200];
+			Actor* combat_target;
+		};
+		std::vector<std::unique_ptr<Actor>> actors;
+		for (uint32_t i = 0; i < ACTORS; i++) {
+			actors.push_back(std::make_unique<Actor>());
+		}
+		for (uint32_t i = 0; i < ACTORS; i++) {
+			actors[i]->combat_target = actors[(i * 7) % ACTORS].get();
+		}
+
+		std::mt19937 rng(3);
+		std::vector<std::pair<uint32_t, uint32_t>> queries(LOOKUPS);
+		for (auto& q : queries) {
+			q = { rng() % ACTORS, rng() % CASTERS };
+		}
+
+		PairCache<bool> cache(2.0f, 10.0f);
+		bool hit;
+		for (uint32_t a = 0; a < ACTORS; a++) {
+			for (uint32_t c = 0; c < CASTERS; c++) {
+				cache.get(a, c, 0.0f, [] { return true; }, hit);
+			}
+		}
+
+		size_t sum = 0;
+		double cached_ns = time_ns([&] {
+			for (const auto& [a, c] : queries) {
+				sum += cache.get(a, c, 1.0f, [] { return false; }, hit);
+			}
+		});
+		double field_ns = time_ns([&] {
+			for (const auto& [a, c] : queries) {
+				sum += actors[a]->combat_target == actors[c].get();
+			}
+		});
+
+		std::printf("pair cache hit: %.1f ns, pointer field compare: %.1f ns (%zu)\n", cached_ns / LOOKUPS,
+			field_ns / LOOKUPS, sum);
+	}
+}
+
+int main()
+{
+	test_ttl();
+	test_invalidate();
+	test_prune();
+	for (int cost : { 0, 100, 1000 }) {
+		bench_scan(100, 4, cost);
+		bench_scan(1000, 16, cost);
+	}
+	bench_hit();
+	return check_result();
+}
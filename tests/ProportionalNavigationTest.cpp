@@ -0,0 +1,93 @@
+#include "Check.h"
+#include "ProportionalNavigation.h"
+
+#include <random>
+
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	float length(const Vec& a) { return std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z); }
+
+	// Closest approach of a projectile steered every frame to a target moving straight
+	float miss_distance(Vec pos, Vec vel, Vec target_pos, const Vec& target_vel, float gain)
+	{
+		constexpr float DTIME = 1.0f / 60;
+		float closest = length({ target_pos.x - pos.x, target_pos.y - pos.y, target_pos.z - pos.z });
+		for (int frame = 0; frame < 600; frame++) {
+			ProportionalNavigation::steer(pos, vel, target_pos, target_vel, gain, DTIME);
+			pos = { pos.x + vel.x * DTIME, pos.y + vel.y * DTIME, pos.z + vel.z * DTIME };
+			target_pos = { target_pos.x + target_vel.x * DTIME, target_pos.y + target_vel.y * DTIME,
+				target_pos.z + target_vel.z * DTIME };
+			closest = std::min(closest, length({ target_pos.x - pos.x, target_pos.y - pos.y, target_pos.z - pos.z }));
+		}
+		return closest;
+	}
+
+	// The line of sight does not rotate on a collision course, nothing to correct
+	void test_collision_course()
+	{
+		Vec pos{ 0, 0, 0 }, vel{ 1000, 0, 0 };
+		Vec target_pos{ 2000, 0, 0 }, target_vel{ -300, 0, 0 };
+		CHECK(ProportionalNavigation::steer(pos, vel, target_pos, target_vel, 4.0f, 1.0f / 60));
+		CHECK_NEAR(vel.x, 1000.0, 1e-3);
+		CHECK_NEAR(vel.y, 0.0, 1e-3);
+		CHECK_NEAR(vel.z, 0.0, 1e-3);
+	}
+
+	// Turns towards the motion of the target and keeps the speed
+	void test_turn()
+	{
+		Vec pos{ 0, 0, 0 }, vel{ 1000, 0, 0 };
+		Vec target_pos{ 2000, 0, 0 }, target_vel{ 0, 300, 0 };
+		ProportionalNavigation::steer(pos, vel, target_pos, target_vel, 4.0f, 1.0f / 60);
+		CHECK(vel.y > 0);
+		CHECK_NEAR(vel.z, 0.0, 1e-3);
+		CHECK_NEAR(length(vel), 1000.0, 1e-2);
+	}
+
+	void test_too_close()
+	{
+		Vec pos{ 0, 0, 0 }, vel{ 1000, 0, 0 };
+		CHECK(!ProportionalNavigation::steer(pos, vel, Vec{ 0.5f, 0, 0 }, Vec{ 0, 300, 0 }, 4.0f, 1.0f / 60));
+		CHECK(vel.x == 1000.0f && vel.y == 0.0f && vel.z == 0.0f);
+	}
+
+	// Launched at where the target is, a faster projectile still gets it
+	void test_hits()
+	{
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> coord(-3000.0f, 3000.0f);
+		std::uniform_real_distribution<float> target_speed(-400.0f, 400.0f);
+		std::uniform_real_distribution<float> speed(1500.0f, 3000.0f);
+
+		int pn_hits = 0, pure_hits = 0;
+		constexpr int SCENES = 200;
+		constexpr float HIT = 30.0f;
+		for (int i = 0; i < SCENES; i++) {
+			Vec target_pos{ coord(rng), coord(rng), coord(rng) / 5 };
+			Vec target_vel{ target_speed(rng), target_speed(rng), 0 };
+			float len = length(target_pos);
+			float s = speed(rng);
+			Vec vel{ target_pos.x / len * s, target_pos.y / len * s, target_pos.z / len * s };
+
+			pn_hits += miss_distance({ 0, 0, 0 }, vel, target_pos, target_vel, 4.0f) < HIT;
+			pure_hits += miss_distance({ 0, 0, 0 }, vel, target_pos, target_vel, 0.0f) < HIT;
+		}
+		CHECK(pn_hits >= SCENES * 95 / 100);
+		CHECK(pure_hits < pn_hits);
+		std::printf("hits within %g units: navigation %d, straight %d of %d\n", HIT, pn_hits, pure_hits, SCENES);
+	}
+}
+
+int main()
+{
+	test_collision_course();
+	test_turn();
+	test_too_close();
+	test_hits();
+	return check_result();
+}
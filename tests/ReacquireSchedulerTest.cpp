@@ -0,0 +1,114 @@
+#include "Check.h"
+#include "ReacquireScheduler.h"
+
+#include <vector>
+
+constexpr uint32_t MAX = ReacquireScheduler::MAX_SCANS_PER_FRAME;
+
+static const void* owner(uint32_t id) { return reinterpret_cast<const void*>(static_cast<uintptr_t>(id) * 16); }
+
+// Every projectile asks every frame, no interval: MAX per frame, oldest waiters first
+static void test_cap_and_order()
+{
+	ReacquireScheduler s;
+	std::vector<uint32_t> served_at(20, 0);
+	for (uint32_t frame = 1; frame <= 3; frame++) {
+		uint32_t granted = 0;
+		for (uint32_t id = 0; id < 20; id++) {
+			if (s.try_acquire(id, owner(id), 1000.0f, frame, frame * 0.016f)) {
+				granted++;
+				CHECK(served_at[id] == 0);
+				served_at[id] = frame;
+			}
+		}
+		CHECK(granted == (frame < 3 ? MAX : 20 - 2 * MAX));
+	}
+	for (uint32_t id = 0; id < 20; id++) {
+		CHECK(served_at[id] == id / MAX + 1);
+	}
+}
+
+static void test_interval()
+{
+	ReacquireScheduler s;
+	CHECK(s.try_acquire(1, owner(1), 0.5f, 1, 0.0f));
+	CHECK(!s.try_acquire(1, owner(1), 0.5f, 2, 0.25f));
+	CHECK(!s.try_acquire(1, owner(1), 0.5f, 3, 0.49f));
+	CHECK(s.try_acquire(1, owner(1), 0.5f, 4, 0.5f));
+}
+
+// Waiters that stopped asking (died) must not block newcomers for long
+static void test_stale_waiters()
+{
+	ReacquireScheduler s;
+	for (uint32_t id = 0; id < 2 * MAX; id++) {
+		s.try_acquire(id, owner(id), 1000.0f, 1, 0.0f);
+	}
+	CHECK(s.waiting() == MAX);
+
+	// The waiters are gone, a newcomer asks every frame
+	uint32_t served = 0;
+	for (uint32_t frame = 2; frame < 2 + ReacquireScheduler::LIVE_FRAMES + 2 && !served; frame++) {
+		if (s.try_acquire(100, owner(100), 1000.0f, frame, frame * 0.016f))
+			served = frame;
+	}
+	CHECK(served != 0);
+	CHECK(served <= 2 + ReacquireScheduler::LIVE_FRAMES);
+}
+
+static void test_remove()
+{
+	ReacquireScheduler s;
+	for (uint32_t id = 0; id < 2 * MAX; id++) {
+		s.try_acquire(id, owner(id), 1000.0f, 1, 0.0f);
+	}
+	for (uint32_t id = MAX; id < 2 * MAX; id++) {
+		s.remove(id, owner(id));
+	}
+	CHECK(s.waiting() == 0);
+	CHECK(s.try_acquire(100, owner(100), 1000.0f, 2, 0.016f));
+}
+
+// Reserved slots go to the old waiters, the rest to newcomers in order of asking
+static void test_leftover_slots()
+{
+	ReacquireScheduler s;
+	for (uint32_t id = 0; id < MAX + 3; id++) {
+		s.try_acquire(id, owner(id), 1000.0f, 1, 0.0f);
+	}
+	CHECK(s.waiting() == 3);
+
+	// Newcomers ask first, still the 3 waiters are served
+	uint32_t granted_new = 0;
+	for (uint32_t id = 100; id < 110; id++) {
+		granted_new += s.try_acquire(id, owner(id), 1000.0f, 2, 0.016f);
+	}
+	CHECK(granted_new == MAX - 3);
+	for (uint32_t id = MAX; id < MAX + 3; id++) {
+		CHECK(s.try_acquire(id, owner(id), 1000.0f, 2, 0.016f));
+	}
+}
+
+// formID reused by another projectile: it is a new one, the interval of the old one does not apply
+static void test_reused_id()
+{
+	ReacquireScheduler s;
+	CHECK(s.try_acquire(1, owner(1), 10.0f, 1, 0.0f));
+	CHECK(!s.try_acquire(1, owner(1), 10.0f, 2, 1.0f));
+	CHECK(s.try_acquire(1, owner(2), 10.0f, 3, 2.0f));
+
+	// remove with a stale owner does nothing
+	s.remove(1, owner(1));
+	CHECK(!s.try_acquire(1, owner(2), 10.0f, 4, 3.0f));
+}
+
+int main()
+{
+	test_cap_and_order();
+	test_interval();
+	test_stale_waiters();
+	test_remove();
+	test_leftover_slots();
+	test_reused_id();
+	return check_result();
+}
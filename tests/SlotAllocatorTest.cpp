@@ -0,0 +1,109 @@
+#include "Check.h"
+#include "SlotAllocator.h"
+
+#include <random>
+#include <set>
+
+namespace
+{
+	void test_lowest_first()
+	{
+		SlotAllocator slots;
+		CHECK(slots.empty());
+		for (uint32_t i = 0; i < 5; i++) {
+			CHECK(slots.claim(5) == i);
+		}
+		CHECK(slots.claim(5) == SlotAllocator::NONE);
+		CHECK(slots.size() == 5);
+
+		slots.release(3);
+		slots.release(1);
+		CHECK(slots.claim(5) == 1);
+		CHECK(slots.claim(5) == 3);
+		CHECK(slots.claim(5) == SlotAllocator::NONE);
+
+		for (uint32_t i = 0; i < 5; i++) {
+			slots.release(i);
+		}
+		CHECK(slots.empty());
+	}
+
+	// Slots past the first word, the hint must go back on release
+	void test_words()
+	{
+		SlotAllocator slots;
+		for (uint32_t i = 0; i < 200; i++) {
+			CHECK(slots.claim(200) == i);
+		}
+		CHECK(slots.claim(200) == SlotAllocator::NONE);
+		slots.release(150);
+		slots.release(5);
+		CHECK(slots.claim(200) == 5);
+		CHECK(slots.claim(200) == 150);
+
+		// A smaller pattern does not get slots past its size
+		slots.release(70);
+		CHECK(slots.claim(64) == SlotAllocator::NONE);
+		CHECK(slots.claim(71) == 70);
+		CHECK(slots.claim(0) == SlotAllocator::NONE);
+	}
+
+	// Slots kept by live followers over a json reload are skipped by new claims
+	void test_take()
+	{
+		SlotAllocator slots;
+		slots.take(1);
+		slots.take(100);
+		slots.take(1);  // twice is once
+		CHECK(slots.size() == 2);
+		CHECK(slots.claim(200) == 0);
+		CHECK(slots.claim(200) == 2);
+
+		for (uint32_t i = 3; i < 100; i++) {
+			CHECK(slots.claim(200) == i);
+		}
+		CHECK(slots.claim(200) == 101);
+
+		slots.release(100);
+		CHECK(slots.claim(200) == 100);
+	}
+
+	// Random claims and releases against a set of taken slots
+	void test_random()
+	{
+		constexpr uint32_t SIZE = 300;
+		std::mt19937 rng(7);
+		SlotAllocator slots;
+		std::set<uint32_t> taken;
+		for (int step = 0; step < 100000; step++) {
+			if (!taken.empty() && rng() % 2) {
+				auto it = taken.begin();
+				std::advance(it, rng() % taken.size());
+				slots.release(*it);
+				taken.erase(it);
+			} else {
+				uint32_t expected = SlotAllocator::NONE;
+				for (uint32_t i = 0; i < SIZE; i++) {
+					if (!taken.count(i)) {
+						expected = i;
+						break;
+					}
+				}
+				auto slot = slots.claim(SIZE);
+				CHECK(slot == expected);
+				if (slot != SlotAllocator::NONE)
+					taken.insert(slot);
+			}
+			CHECK(slots.size() == taken.size());
+		}
+	}
+}
+
+int main()
+{
+	test_lowest_first();
+	test_words();
+	test_take();
+	test_random();
+	return check_result();
+}
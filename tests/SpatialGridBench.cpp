@@ -0,0 +1,128 @@
+#include "Check.h"
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+// Checks grid queries against the linear scan and prints timings of both
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Entry
+	{
+		uint32_t id;
+		Vec pos;
+	};
+
+	constexpr float AREA = 20480.0f;  // 5x5 loaded cells
+	constexpr float RADIUS = 4000.0f;
+	constexpr int QUERIES = 2000;
+
+	std::vector<Entry> random_entries(std::mt19937& rng, size_t n)
+	{
+		std::uniform_real_distribution<float> xy(-AREA / 2, AREA / 2);
+		std::uniform_real_distribution<float> z(-500.0f, 500.0f);
+		std::vector<Entry> ans;
+		for (uint32_t i = 0; i < n; i++) {
+			ans.push_back({ i, { xy(rng), xy(rng), z(rng) } });
+		}
+		return ans;
+	}
+
+	float dist2(const Vec& a, const Vec& b)
+	{
+		float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	Vec random_dir(std::mt19937& rng)
+	{
+		std::normal_distribution<float> n;
+		Vec d{ n(rng), n(rng), n(rng) };
+		float len = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+		return { d.x / len, d.y / len, d.z / len };
+	}
+
+	template <typename F>
+	double time_ns(F&& f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void run(size_t n)
+	{
+		std::mt19937 rng(static_cast<uint32_t>(n));
+		auto entries = random_entries(rng, n);
+
+		SpatialGrid<Entry> grid;
+		double build_ns = time_ns([&] { grid.build(entries); });
+
+		std::vector<Vec> origins, dirs;
+		for (int i = 0; i < QUERIES; i++) {
+			origins.push_back(random_entries(rng, 1)[0].pos);
+			dirs.push_back(random_dir(rng));
+		}
+		const float cos_max = std::cos(0.5f);
+
+		// Correctness
+		std::vector<uint32_t> a, b;
+		for (int q = 0; q < QUERIES; q++) {
+			a.clear();
+			b.clear();
+			grid.forEachInRadius(origins[q], RADIUS, [&a](const Entry& e) { a.push_back(e.id); });
+			for (const auto& e : entries) {
+				if (dist2(origins[q], e.pos) < RADIUS * RADIUS)
+					b.push_back(e.id);
+			}
+			std::sort(a.begin(), a.end());
+			std::sort(b.begin(), b.end());
+			CHECK(a == b);
+
+			a.clear();
+			b.clear();
+			grid.forEachInCone(origins[q], dirs[q], cos_max, RADIUS, [&a](const Entry& e) { a.push_back(e.id); });
+			for (const auto& e : entries) {
+				if (dist2(origins[q], e.pos) < RADIUS * RADIUS &&
+					SpatialGrid<Entry>::in_cone(origins[q], dirs[q], cos_max, e.pos))
+					b.push_back(e.id);
+			}
+			std::sort(a.begin(), a.end());
+			std::sort(b.begin(), b.end());
+			CHECK(a == b);
+		}
+
+		// Timings, `found` keeps the loops alive
+		size_t found = 0;
+		double grid_ns = time_ns([&] {
+			for (int q = 0; q < QUERIES; q++) {
+				grid.forEachInRadius(origins[q], RADIUS, [&found](const Entry&) { found++; });
+			}
+		});
+		double linear_ns = time_ns([&] {
+			for (int q = 0; q < QUERIES; q++) {
+				for (const auto& e : entries) {
+					if (dist2(origins[q], e.pos) < RADIUS * RADIUS)
+						found++;
+				}
+			}
+		});
+
+		std::printf("%5zu actors: build %8.0f ns, radius query: grid %7.0f ns, linear %7.0f ns (%zu found)\n", n, build_ns,
+			grid_ns / QUERIES, linear_ns / QUERIES, found / 2);
+	}
+}
+
+int main()
+{
+	for (size_t n : { 0, 1, 20, 60, 100, 200, 1000, 10000 }) {
+		run(n);
+	}
+	return check_result();
+}
@@ -0,0 +1,235 @@
+#include "AsyncScanner.h"
+#include "Check.h"
+
+#include <chrono>
+#include <map>
+#include <random>
+
+// Many frames of request / on_frame / take with moving actors, answers are checked against a brute force scan
+// of the snapshot they could have been made from
+namespace
+{
+	struct Vec
+	{
+		float x, y, z;
+	};
+
+	struct Actor
+	{
+		uint32_t id;
+		Vec pos;
+		bool alive;
+	};
+
+	using Scanner = AsyncScanner<Actor, uint32_t, Vec>;
+
+	constexpr uint64_t NOT_CLUSTER = 4;  // filter key of the cluster test
+	constexpr uint32_t CLUSTER = 20;     // first actors, all at the same point, so ties are broken by index
+
+	// Filters 0..3 drop a quarter of actors by id and the dead ones
+	bool passes(uint64_t key, const Actor& a)
+	{
+		if (key == NOT_CLUSTER)
+			return a.id >= CLUSTER;
+		return a.alive && a.id % 4 != key;
+	}
+
+	Scanner::Filter get_filter(uint64_t key)
+	{
+		return [key](Actor* a) { return passes(key, *a); };
+	}
+
+	auto get_entry(const Actor& a) { return Scanner::Entry{ const_cast<Actor*>(&a), a.id, a.pos }; }
+
+	struct Asked
+	{
+		Vec origin;
+		float within_dist2;
+		uint64_t key;
+		size_t frame;  // first snapshot the answer may be made from
+	};
+
+	// Filter first, then the nearest ones
+	std::vector<uint32_t> brute_force(const std::vector<Actor>& actors, const Asked& asked)
+	{
+		std::vector<std::pair<float, uint32_t>> all;
+		for (uint32_t i = 0; i < actors.size(); i++) {
+			const auto& a = actors[i];
+			if (!passes(asked.key, a))
+				continue;
+
+			float dx = a.pos.x - asked.origin.x, dy = a.pos.y - asked.origin.y, dz = a.pos.z - asked.origin.z;
+			float dist2 = dx * dx + dy * dy + dz * dz;
+			if (dist2 < asked.within_dist2)
+				all.push_back({ dist2, i });
+		}
+		std::sort(all.begin(), all.end());
+
+		std::vector<uint32_t> ans;
+		for (size_t i = 0; i < all.size() && i < Scanner::MAX_CANDIDATES; i++) {
+			ans.push_back(actors[all[i].second].id);
+		}
+		return ans;
+	}
+
+	struct Stress
+	{
+		std::mt19937 rng{ 11 };
+		std::vector<Actor> actors;
+		std::vector<std::vector<Actor>> snapshots;  // actors as they were at every on_frame
+		std::map<uint32_t, Asked> outstanding;
+		Scanner scanner;
+		size_t asked = 0, answered = 0, full = 0, empty = 0;
+
+		Stress()
+		{
+			std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+			for (uint32_t i = 0; i < 400; i++) {
+				actors.push_back({ i, { coord(rng), coord(rng), coord(rng) / 10 }, true });
+			}
+			for (uint32_t i = 0; i < CLUSTER; i++) {
+				actors[i].pos = { 100.0f, 100.0f, 0.0f };
+			}
+			scanner.start();
+		}
+
+		void move()
+		{
+			std::uniform_real_distribution<float> step(-50.0f, 50.0f);
+			for (auto& a : actors) {
+				if (a.id < CLUSTER)
+					continue;
+				a.pos = { a.pos.x + step(rng), a.pos.y + step(rng), a.pos.z };
+				if (rng() % 50 == 0)
+					a.alive = !a.alive;
+			}
+		}
+
+		void ask()
+		{
+			std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+			std::uniform_real_distribution<float> dist(200.0f, 4000.0f);
+			for (int i = 0; i < 40; i++) {
+				auto id = static_cast<uint32_t>(rng() % 200);
+				uint64_t key = rng() % 5;
+				Asked cur{ { coord(rng), coord(rng), 0 }, dist(rng), key, snapshots.size() };
+				if (key == NOT_CLUSTER) {
+					cur.origin = { 100.0f, 100.0f, 0.0f };
+					cur.within_dist2 = 1e10f;
+				}
+				cur.within_dist2 *= cur.within_dist2;
+
+				// A repeated request is ignored until the first one is answered
+				CHECK(scanner.is_waiting(id) == outstanding.contains(id));
+				scanner.request(id, cur.origin, cur.within_dist2, key, get_filter(key));
+				CHECK(scanner.is_waiting(id));
+				if (outstanding.try_emplace(id, cur).second)
+					asked++;
+			}
+		}
+
+		void frame()
+		{
+			snapshots.push_back(actors);
+			scanner.on_frame(actors, get_entry);
+
+			for (uint32_t id = 0; id < 200; id++) {
+				auto ans = scanner.take(id);
+				if (!ans)
+					continue;
+
+				// Once, and only for what was asked
+				CHECK(!scanner.take(id));
+				CHECK(!scanner.is_waiting(id));
+				auto found = outstanding.find(id);
+				CHECK(found != outstanding.end());
+				if (found == outstanding.end())
+					continue;
+
+				// Exactly the nearest ones of some snapshot since the request, in order
+				bool same = false;
+				for (size_t f = found->second.frame; f < snapshots.size() && !same; f++) {
+					same = *ans == brute_force(snapshots[f], found->second);
+				}
+				CHECK(same);
+
+				// Filtered actors never take places of farther ones
+				if (found->second.key == NOT_CLUSTER) {
+					CHECK(ans->size() == Scanner::MAX_CANDIDATES);
+					for (auto a : *ans) {
+						CHECK(a >= CLUSTER);
+					}
+				}
+
+				full += ans->size() == Scanner::MAX_CANDIDATES;
+				empty += ans->empty();
+				outstanding.erase(found);
+				answered++;
+			}
+		}
+
+		void run()
+		{
+			for (int i = 0; i < 1000; i++) {
+				move();
+				ask();
+				frame();
+			}
+
+			// The worker is not waited for in frames, let it catch up
+			for (int i = 0; i < 1000 && !outstanding.empty(); i++) {
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+				frame();
+			}
+
+			CHECK(outstanding.empty());
+			CHECK(asked == answered);
+			CHECK(full > 0 && empty > 0);
+			std::printf("%zu requests answered once each, %zu full, %zu empty, in %zu frames\n", answered, full, empty,
+				snapshots.size());
+		}
+	};
+
+	// Shutdown joins with a job in flight, drops everything, the scanner starts again
+	void test_shutdown()
+	{
+		std::vector<Actor> actors;
+		for (uint32_t i = 0; i < 20000; i++) {
+			actors.push_back({ i, { float(i), 0, 0 }, true });
+		}
+
+		Scanner scanner;
+		scanner.shutdown();  // not started
+		scanner.start();
+		for (uint32_t id = 0; id < 100; id++) {
+			scanner.request(id, { 0, 0, 0 }, 1e12f, 0, get_filter(0));
+		}
+		scanner.on_frame(actors, get_entry);
+		scanner.shutdown();
+		scanner.shutdown();
+		scanner.on_frame(actors, get_entry);
+		CHECK(!scanner.is_waiting(0));
+		CHECK(!scanner.take(0));
+
+		scanner.start();
+		scanner.request(7, { 0, 0, 0 }, 1e12f, 0, get_filter(0));
+		std::optional<std::vector<uint32_t>> ans;
+		for (int i = 0; i < 10000 && !ans; i++) {
+			scanner.on_frame(actors, get_entry);
+			ans = scanner.take(7);
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		CHECK(ans && ans->size() == Scanner::MAX_CANDIDATES && ans->front() == 1);
+
+		// The destructor joins a running job too
+		scanner.request(8, { 0, 0, 0 }, 1e12f, 0, get_filter(0));
+		scanner.on_frame(actors, get_entry);
+	}
+}
+
+int main()
+{
+	Stress().run();
+	test_shutdown();
+	return check_result();
+}
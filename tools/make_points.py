@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Converts a list of points to a points file of the Custom pattern shape.
+
+Input is a text file with a point per line ("x y z" or "x, y, z", z may be omitted,
+lines starting with # are skipped) or a json array of [x, y, z] points.
+Coordinates are along (right, up, forward) of the pattern plane and are scaled by the figure size.
+
+Usage: make_points.py input.txt output.nppc [--normalize]
+"""
+
+import argparse
+import json
+import struct
+
+MAGIC = b"NPPC"
+VERSION = 1
+WIDTH = 4  # SIMD width, arrays are padded to it
+
+
+def read_points(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+
+    if text.lstrip().startswith("["):
+        rows = json.loads(text)
+    else:
+        rows = []
+        for line in text.splitlines():
+            line = line.strip()
+            if line and not line.startswith("#"):
+                rows.append([float(v) for v in line.replace(",", " ").split()])
+
+    points = []
+    for row in rows:
+        if not 2 <= len(row) <= 3:
+            raise ValueError(f"bad point {row}")
+        points.append((float(row[0]), float(row[1]), float(row[2]) if len(row) == 3 else 0.0))
+    if not points:
+        raise ValueError("no points")
+    return points
+
+
+def normalize(points):
+    radius = max((x * x + y * y + z * z) ** 0.5 for x, y, z in points)
+    if radius == 0:
+        return points
+    return [(x / radius, y / radius, z / radius) for x, y, z in points]
+
+
+def write_points(path, points):
+    count = len(points)
+    padded = (count + WIDTH - 1) // WIDTH * WIDTH
+    with open(path, "wb") as f:
+        f.write(struct.pack("<4sIII", MAGIC, VERSION, count, 0))
+        for axis in range(3):
+            values = [p[axis] for p in points] + [0.0] * (padded - count)
+            f.write(struct.pack(f"<{padded}f", *values))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--normalize", action="store_true", help="scale points to fit the unit sphere")
+    args = parser.parse_args()
+
+    points = read_points(args.input)
+    if args.normalize:
+        points = normalize(points)
+    write_points(args.output, points)
+    print(f"{len(points)} points written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()